@@ -2,36 +2,831 @@
    Lyman Shen
    April 6, 2017
    Purpose:To count number of words in a text file
+   Usage: count [-m] [-j N] [-c cache] file...
+	  count [-m] [-j N] [-c cache] -f list
+	  count [-m] --top K file...
+	  count [-m] --top K -f list
+	-m: memory-map the file and find word boundaries 64 bytes at a time
+	    instead of calling fscanf once per word
+	-j: as -m, but split the file into N ranges counted on their own threads;
+	    with several files, count N files at a time instead
+	--top: also list the K most frequent words, using memory for K words only;
+	    the words are read on one thread and never cached, so -j and -c are
+	    not allowed with it
+	-f: read the names of the files to count from list, one per line
+	-c: keep each file's count in the cache file, and only count a file again
+	    once its size or modification time changes
+	With several files, the count for each file is printed and then the total.
 */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "cache.h"
 
 #define MAX_WORD_LENGTH 30
+#define MAX_THREADS 256
+#define p(x) (((x)-1)/2)
+#define l(x) (((x)*2)+1)
+#define r(x) (((x)*2)+2)
 
-int main(int argc, char *argv[])
+//fscanf splits a run of L non-space characters into this many words
+#define TOKENS(L) (((L) + MAX_WORD_LENGTH - 1) / MAX_WORD_LENGTH)
+
+//Word counts for a range of bytes, kept so that ranges can be joined later
+struct tally {
+	long words; //words in runs that start and end inside the range
+	long lead; //length of the run touching the start of the range
+	long run; //length of the run touching the end of the range
+	bool spaced; //false if the range has no whitespace at all
+};
+
+//A word tracked by the top-K summary
+struct counter {
+	char word[MAX_WORD_LENGTH+1];
+	int len;
+	unsigned hash;
+	long count; //times seen, possibly including the count of the word it replaced
+	long error; //most that count can be too high
+	int pos; //index in the heap
+};
+
+//Space-Saving summary: k counters, a min-heap by count, and a hash table of counter indices
+struct summary {
+	struct counter *counters;
+	int *heap;
+	int *table;
+	int mask;
+	int k;
+	int used;
+	long total;
+};
+
+/*
+   Function: isSpace
+   Description: Same test as isspace() in the C locale, which is what %s uses
+*/
+static inline bool isSpace(unsigned char c)
+{
+	return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t';
+}
+
+/*
+   Function: wordMask
+   Description: Return a mask with bit i set if byte i of the 64 bytes at p is not whitespace
+*/
+static inline uint64_t wordMask(const unsigned char *p)
+{
+	uint64_t mask = 0;
+#ifdef __SSE2__
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i range = _mm_set1_epi8('\r' - '\t');
+	int i;
+	for(i=0; i<4; i++)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i *)(p + 16*i));
+		__m128i d = _mm_sub_epi8(x, tab);
+		//Byte is \t..\r when (x - '\t') <= 4 as an unsigned value
+		__m128i ctl = _mm_cmpeq_epi8(_mm_min_epu8(d, range), d);
+		__m128i ws = _mm_or_si128(ctl, _mm_cmpeq_epi8(x, space));
+		mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(ws) << (16*i);
+	}
+	return ~mask;
+#else
+	int i;
+	for(i=0; i<64; i++)
+		mask |= (uint64_t)!isSpace(p[i]) << i;
+	return mask;
+#endif
+}
+
+/*
+   Function: endRun
+   Description: Account for a run of non-space characters that has just ended
+*/
+static inline void endRun(struct tally *t, long run)
+{
+	if(!t->spaced)
+	{
+		t->lead = run;
+		t->spaced = true;
+	}
+	else if(run > 0)
+		t->words += TOKENS(run);
+}
+
+/*
+   Function: scanBytes
+   Description: Update the tally one byte at a time; used for the tail of a range
+   	and for blocks holding a word too long to count with a popcount
+*/
+static void scanBytes(struct tally *t, const unsigned char *p, size_t n)
+{
+	size_t i;
+	for(i=0; i<n; i++)
+	{
+		if(!isSpace(p[i]))
+			t->run++;
+		else
+		{
+			endRun(t, t->run);
+			t->run = 0;
+		}
+	}
+}
+
+/*
+   Function: scanRange
+   Description: Count the words in n bytes at p without copying any of them.
+   	Each 64 byte block is turned into a bit mask; a word starts at every 1 bit
+   	whose previous bit is 0, so the words inside a block are a popcount.
+*/
+static void scanRange(struct tally *t, const unsigned char *p, size_t n)
+{
+	uint64_t m, starts, inner, r;
+	int lead, tail;
+	t->words = t->lead = t->run = 0;
+	t->spaced = false;
+	while(n >= 64)
+	{
+		m = wordMask(p);
+		if(m == ~(uint64_t)0)
+		{
+			//Whole block is inside one word
+			t->run += 64;
+			p += 64;
+			n -= 64;
+			continue;
+		}
+		//Finish the word carried in from the previous block
+		lead = __builtin_ctzll(~m);
+		tail = __builtin_clzll(~m);
+		endRun(t, t->run + lead);
+		//Words that start after the first space and end before the block does
+		inner = m & ~((((uint64_t)2) << lead) - 1);
+		if(tail > 0)
+			inner &= ~(uint64_t)0 >> tail;
+		//A run of 31 set bits means fscanf would split a word; count those slowly
+		r = inner;
+		r &= r >> 1;
+		r &= r >> 2;
+		r &= r >> 4;
+		r &= r >> 8;
+		r &= r >> 15;
+		if(r != 0)
+		{
+			t->run = 0;
+			scanBytes(t, p + lead + 1, 64 - tail - lead - 1);
+		}
+		else
+		{
+			starts = inner & ~(inner << 1);
+			t->words += __builtin_popcountll(starts);
+		}
+		t->run = tail;
+		p += 64;
+		n -= 64;
+	}
+	scanBytes(t, p, n);
+}
+
+//One thread's share of a mapped file
+struct job {
+	const unsigned char *p;
+	size_t n;
+	struct tally t;
+	pthread_t thread;
+	bool started; //false if the range was counted on the calling thread
+};
+
+/*
+   Function: scanJob
+   Description: Thread entry point to count the words in one range
+*/
+static void *scanJob(void *arg)
+{
+	struct job *jp = arg;
+	scanRange(&jp->t, jp->p, jp->n);
+	return NULL;
+}
+
+/*
+   Function: joinTallies
+   Description: Add up the tallies of consecutive ranges. A word cut by a range
+   	boundary is the tail run of one range plus the lead run of the next, and
+   	a range with no whitespace just makes the carried run longer.
+*/
+static long joinTallies(struct tally *t, int n)
+{
+	long num = 0;
+	long run = 0;
+	int i;
+	for(i=0; i<n; i++)
+	{
+		if(!t[i].spaced)
+			run += t[i].run;
+		else
+		{
+			num += TOKENS(run + t[i].lead) + t[i].words;
+			run = t[i].run;
+		}
+	}
+	return num + TOKENS(run);
+}
+
+/*
+   Function: mapFile
+   Description: Map a whole file read-only; return -1 on error.
+   	An empty file cannot be mapped, so it gives a NULL map of size 0.
+*/
+static int mapFile(const char *path, const unsigned char **map, size_t *size)
+{
+	struct stat st;
+	void *addr;
+	int fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return -1;
+	if(fstat(fd, &st) < 0)
+	{
+		close(fd);
+		return -1;
+	}
+	*map = NULL;
+	*size = st.st_size;
+	if(st.st_size == 0)
+	{
+		close(fd);
+		return 0;
+	}
+	addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(addr == MAP_FAILED)
+		return -1;
+	madvise(addr, st.st_size, MADV_SEQUENTIAL);
+	*map = addr;
+	return 0;
+}
+
+/*
+   Function: countMapped
+   Description: Count words by mapping the file into memory and splitting it
+   	among nthreads threads; return -1 on error
+*/
+static long countMapped(const char *path, int nthreads)
+{
+	struct job jobs[MAX_THREADS];
+	struct tally t[MAX_THREADS];
+	const unsigned char *map;
+	size_t size, chunk;
+	int i;
+	if(mapFile(path, &map, &size) < 0)
+		return -1;
+	if(size == 0)
+		return 0;
+	//Give each thread at least one block
+	if((size_t)nthreads > size / 64)
+		nthreads = size / 64 + 1;
+	chunk = size / nthreads;
+	for(i=0; i<nthreads; i++)
+	{
+		jobs[i].p = map + i * chunk;
+		jobs[i].n = (i == nthreads-1) ? size - i * chunk : chunk;
+	}
+	//Count the first range on this thread, and any range a thread could not start for
+	for(i=1; i<nthreads; i++)
+	{
+		jobs[i].started = pthread_create(&jobs[i].thread, NULL, scanJob, &jobs[i]) == 0;
+		if(!jobs[i].started)
+			scanJob(&jobs[i]);
+	}
+	scanJob(&jobs[0]);
+	for(i=0; i<nthreads; i++)
+	{
+		if(i > 0 && jobs[i].started)
+			pthread_join(jobs[i].thread, NULL);
+		t[i] = jobs[i].t;
+	}
+	munmap((void *)map, size);
+	return joinTallies(t, nthreads);
+}
+
+/*
+   Function: wordHash
+   Description: Hash the len bytes of a word
+*/
+static unsigned wordHash(const unsigned char *s, int len)
+{
+	unsigned hash = 0;
+	while(len-- > 0)
+		hash = 31 * hash + *s++;
+	return hash;
+}
+
+/*
+   Function: createSummary
+   Description: Allocate a Space-Saving summary that tracks k words.
+   	The table of counter indices is a power of two at least twice k.
+*/
+static struct summary *createSummary(int k)
+{
+	struct summary *sp = malloc(sizeof(struct summary));
+	assert(sp != NULL);
+	sp->k = k;
+	sp->used = 0;
+	sp->total = 0;
+	sp->counters = malloc(sizeof(struct counter) * k);
+	sp->heap = malloc(sizeof(int) * k);
+	assert(sp->counters != NULL && sp->heap != NULL);
+	for(sp->mask = 1; sp->mask < 2*k; sp->mask <<= 1)
+		;
+	sp->table = malloc(sizeof(int) * sp->mask);
+	assert(sp->table != NULL);
+	memset(sp->table, -1, sizeof(int) * sp->mask);
+	sp->mask--;
+	return sp;
+}
+
+/*
+   Function: destroySummary
+   Description: Free a summary
+*/
+static void destroySummary(struct summary *sp)
+{
+	free(sp->counters);
+	free(sp->heap);
+	free(sp->table);
+	free(sp);
+}
+
+/*
+   Function: swapHeap
+   Description: Swap two heap entries and keep the counters' positions right
+*/
+static void swapHeap(struct summary *sp, int i, int j)
+{
+	int temp = sp->heap[i];
+	sp->heap[i] = sp->heap[j];
+	sp->heap[j] = temp;
+	sp->counters[sp->heap[i]].pos = i;
+	sp->counters[sp->heap[j]].pos = j;
+}
+
+/*
+   Function: siftUp
+   Description: Move a new counter up the min-heap
+*/
+static void siftUp(struct summary *sp, int i)
+{
+	while(i > 0 && sp->counters[sp->heap[p(i)]].count > sp->counters[sp->heap[i]].count)
+	{
+		swapHeap(sp, i, p(i));
+		i = p(i);
+	}
+}
+
+/*
+   Function: siftDown
+   Description: Move a counter whose count grew down the min-heap
+*/
+static void siftDown(struct summary *sp, int i)
+{
+	int child;
+	while((child = l(i)) < sp->used)
+	{
+		if(r(i) < sp->used && sp->counters[sp->heap[r(i)]].count < sp->counters[sp->heap[child]].count)
+			child = r(i);
+		if(sp->counters[sp->heap[i]].count <= sp->counters[sp->heap[child]].count)
+			break;
+		swapHeap(sp, i, child);
+		i = child;
+	}
+}
+
+/*
+   Function: findSlot
+   Description: Return the table slot holding the word, or the empty slot where it would go
+*/
+static int findSlot(struct summary *sp, const unsigned char *word, int len, unsigned hash)
+{
+	int slot = hash & sp->mask;
+	struct counter *cp;
+	while(sp->table[slot] != -1)
+	{
+		cp = &sp->counters[sp->table[slot]];
+		if(cp->hash == hash && cp->len == len && memcmp(cp->word, word, len) == 0)
+			break;
+		slot = (slot + 1) & sp->mask;
+	}
+	return slot;
+}
+
+/*
+   Function: removeSlot
+   Description: Empty a table slot, shifting later entries of its cluster back
+   	so that no deleted markers are needed
+*/
+static void removeSlot(struct summary *sp, int hole)
+{
+	int slot = hole;
+	int home;
+	while(1)
+	{
+		slot = (slot + 1) & sp->mask;
+		if(sp->table[slot] == -1)
+			break;
+		home = sp->counters[sp->table[slot]].hash & sp->mask;
+		//Entry may fill the hole if the hole lies between its home and its slot
+		if(((slot - home) & sp->mask) >= ((slot - hole) & sp->mask))
+		{
+			sp->table[hole] = sp->table[slot];
+			hole = slot;
+		}
+	}
+	sp->table[hole] = -1;
+}
+
+/*
+   Function: addWord
+   Description: Count one word. A word already tracked gets its count bumped.
+   	Otherwise it takes over the counter with the smallest count, inheriting
+   	that count as its possible overestimate.
+*/
+static void addWord(struct summary *sp, const unsigned char *word, int len)
+{
+	unsigned hash = wordHash(word, len);
+	int slot = findSlot(sp, word, len, hash);
+	int i;
+	struct counter *cp;
+	sp->total++;
+	if(sp->table[slot] != -1)
+	{
+		cp = &sp->counters[sp->table[slot]];
+		cp->count++;
+		siftDown(sp, cp->pos);
+		return;
+	}
+	if(sp->used < sp->k)
+	{
+		//Take a free counter
+		i = sp->used++;
+		sp->counters[i].count = 0;
+		sp->counters[i].error = 0;
+		sp->heap[i] = i;
+		sp->counters[i].pos = i;
+	}
+	else
+	{
+		i = sp->heap[0];
+		removeSlot(sp, findSlot(sp, (unsigned char *)sp->counters[i].word, sp->counters[i].len, sp->counters[i].hash));
+		sp->counters[i].error = sp->counters[i].count;
+		slot = findSlot(sp, word, len, hash);
+	}
+	cp = &sp->counters[i];
+	memcpy(cp->word, word, len);
+	cp->word[len] = '\0';
+	cp->len = len;
+	cp->hash = hash;
+	cp->count++;
+	sp->table[slot] = i;
+	siftUp(sp, cp->pos);
+	siftDown(sp, cp->pos);
+}
+
+/*
+   Function: compareCounters
+   Description: Order counters by decreasing count for qsort
+*/
+static int compareCounters(const void *a, const void *b)
+{
+	const struct counter *c1 = a, *c2 = b;
+	if(c1->count != c2->count)
+		return c1->count < c2->count ? 1 : -1;
+	return strcmp(c1->word, c2->word);
+}
+
+/*
+   Function: topMapped
+   Description: Feed every word of a file into the summary, splitting long
+   	runs every MAX_WORD_LENGTH characters as fscanf does; return -1 on error
+*/
+static int topMapped(struct summary *sp, const char *path)
+{
+	const unsigned char *map;
+	size_t size, i, start;
+	if(mapFile(path, &map, &size) < 0)
+		return -1;
+	i = 0;
+	while(i < size)
+	{
+		//Skip whitespace, then take up to MAX_WORD_LENGTH characters
+		while(i < size && isSpace(map[i]))
+			i++;
+		start = i;
+		while(i < size && !isSpace(map[i]) && i - start < MAX_WORD_LENGTH)
+			i++;
+		if(i > start)
+			addWord(sp, map + start, i - start);
+	}
+	if(map != NULL)
+		munmap((void *)map, size);
+	return 0;
+}
+
+/*
+   Function: printSummary
+   Description: Print the tracked words from most to least frequent. Each
+   	count may be too high by at most the error shown, never too low.
+*/
+static void printSummary(struct summary *sp)
+{
+	int i;
+	qsort(sp->counters, sp->used, sizeof(struct counter), compareCounters);
+	printf("%ld total words\n", sp->total);
+	for(i=0; i<sp->used; i++)
+		printf("%s: %ld (error <= %ld)\n", sp->counters[i].word, sp->counters[i].count, sp->counters[i].error);
+}
+
+/*
+   Function: countScanned
+   Description: Count words with fscanf; return -1 on error
+*/
+static long countScanned(const char *path)
 {
 	//Open file
-	FILE *fp = fopen(argv[1],"r");
+	FILE *fp = fopen(path,"r");
 	//Check if file is successfully inserted
 	if(fp == NULL)
-	{
-		printf("Error reading file.\n");
-		return 1;
-	}
-	int num = 0;
+		return -1;
+	long num = 0;
 	char word[MAX_WORD_LENGTH+1];
-	int read;
 	//Read words while there are words to read
-	while(fscanf(fp,"%30s%n",word,&read) == 1)
+	while(fscanf(fp,"%30s",word) == 1)
 	{
-		*(word+read) = '\0';
 		//Update counter
 		num++;
 	}
 	//Close file
 	fclose(fp);
-	//Show counter
-	printf("%d total words\n",num);
-	return 0;
+	return num;
+}
+
+/*
+   Function: countFile
+   Description: Count the words in a file with the chosen method, unless the
+   	cache has a count for it; return -1 on error
+*/
+static long countFile(char *path, bool mflag, int nthreads, CACHE *cache)
+{
+	long num, distinct;
+	struct stat st;
+	//Take the status before counting so a changed file is never cached
+	if(cache != NULL && stat(path, &st) < 0)
+		cache = NULL;
+	if(cache != NULL && findEntry(cache, "count", path, &st, &num, &distinct, NULL))
+		return num;
+	num = mflag ? countMapped(path, nthreads) : countScanned(path);
+	if(cache != NULL && num >= 0)
+		addEntry(cache, "count", path, &st, num, 0, NULL);
+	return num;
+}
+
+//One file of a batch
+struct file {
+	char *path;
+	long words; //-1 if the file could not be read
+};
+
+//Files shared by the threads counting a batch
+struct batch {
+	struct file *files;
+	int nfiles;
+	int next; //next file to hand out
+	bool mflag;
+	CACHE *cache;
+	pthread_mutex_t lock;
+};
+
+/*
+   Function: batchWorker
+   Description: Thread entry point; count files from the batch until none are left
+*/
+static void *batchWorker(void *arg)
+{
+	struct batch *bp = arg;
+	struct file *fp;
+	while(1)
+	{
+		pthread_mutex_lock(&bp->lock);
+		fp = bp->next < bp->nfiles ? &bp->files[bp->next++] : NULL;
+		pthread_mutex_unlock(&bp->lock);
+		if(fp == NULL)
+			return NULL;
+		fp->words = countFile(fp->path, bp->mflag, 1, bp->cache);
+	}
+}
+
+/*
+   Function: countBatch
+   Description: Count every file in the batch using a pool of nthreads threads
+*/
+static void countBatch(struct batch *bp, int nthreads)
+{
+	pthread_t threads[MAX_THREADS];
+	int i, started;
+	if(nthreads > bp->nfiles)
+		nthreads = bp->nfiles;
+	bp->next = 0;
+	pthread_mutex_init(&bp->lock, NULL);
+	for(started=0; started<nthreads-1; started++)
+		if(pthread_create(&threads[started], NULL, batchWorker, bp) != 0)
+			break;
+	//This thread works too, so the batch finishes even if no thread started
+	batchWorker(bp);
+	for(i=0; i<started; i++)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&bp->lock);
+}
+
+/*
+   Function: readList
+   Description: Read file names from a list file, one per line; return the
+   	number of names, or -1 if the list cannot be read
+*/
+static int readList(const char *path, char ***names)
+{
+	FILE *fp = fopen(path, "r");
+	char *line = NULL;
+	size_t size = 0;
+	ssize_t len;
+	int n = 0, length = 16;
+	if(fp == NULL)
+		return -1;
+	*names = malloc(sizeof(char *) * length);
+	assert(*names != NULL);
+	while((len = getline(&line, &size, fp)) != -1)
+	{
+		if(len > 0 && line[len-1] == '\n')
+			line[--len] = '\0';
+		if(len == 0)
+			continue;
+		if(n == length)
+		{
+			length *= 2;
+			*names = realloc(*names, sizeof(char *) * length);
+			assert(*names != NULL);
+		}
+		(*names)[n] = strdup(line);
+		assert((*names)[n] != NULL);
+		n++;
+	}
+	free(line);
+	fclose(fp);
+	return n;
+}
+
+int main(int argc, char *argv[])
+{
+	bool mflag = false;
+	int nthreads = 1;
+	int top = 0;
+	long num;
+	struct summary *sp;
+	struct batch batch;
+	char *list = NULL;
+	char *cachePath = NULL;
+	char **names;
+	CACHE *cache = NULL;
+	int nnames, i;
+	int status = 0;
+	//Check for memory-mapped and threaded modes
+	while(argc > 1 && argv[1][0] == '-')
+	{
+		if(strcmp(argv[1], "-m") == 0)
+			mflag = true;
+		else if(strcmp(argv[1], "-j") == 0 && argc > 2)
+		{
+			mflag = true;
+			nthreads = atoi(argv[2]);
+			argc--;
+			argv++;
+		}
+		else if(strcmp(argv[1], "--top") == 0 && argc > 2)
+		{
+			top = atoi(argv[2]);
+			argc--;
+			argv++;
+		}
+		else if(strcmp(argv[1], "-f") == 0 && argc > 2)
+		{
+			list = argv[2];
+			argc--;
+			argv++;
+		}
+		else if(strcmp(argv[1], "-c") == 0 && argc > 2)
+		{
+			cachePath = argv[2];
+			argc--;
+			argv++;
+		}
+		else
+			break;
+		argc--;
+		argv++;
+	}
+	if((list == NULL) == (argc < 2) || nthreads < 1 || nthreads > MAX_THREADS || top < 0 ||
+		(top > 0 && (nthreads > 1 || cachePath != NULL)))
+	{
+		fprintf(stderr, "usage: count [-m] [-j N] [-c cache] file...\n");
+		fprintf(stderr, "       count [-m] [-j N] [-c cache] -f list\n");
+		fprintf(stderr, "       count [-m] --top K file...\n");
+		fprintf(stderr, "       count [-m] --top K -f list\n");
+		return 1;
+	}
+	//Get the names of the files to count
+	names = argv + 1;
+	nnames = argc - 1;
+	if(list != NULL && (nnames = readList(list, &names)) < 0)
+	{
+		printf("Error reading file.\n");
+		return 1;
+	}
+	if(cachePath != NULL)
+		cache = createCache(cachePath);
+	//The summary needs the words themselves, so it makes its own pass over every file
+	if(top > 0)
+	{
+		sp = createSummary(top);
+		for(i=0; i<nnames && status == 0; i++)
+		{
+			if(topMapped(sp, names[i]) < 0)
+			{
+				printf("Error reading file.\n");
+				status = 1;
+			}
+		}
+		if(status == 0)
+			printSummary(sp);
+		destroySummary(sp);
+	}
+	//Count several files at once, then show each count and the total
+	else if(list != NULL || nnames > 1)
+	{
+		batch.files = malloc(sizeof(struct file) * nnames);
+		assert(batch.files != NULL || nnames == 0);
+		batch.nfiles = nnames;
+		batch.mflag = mflag;
+		batch.cache = cache;
+		for(i=0; i<nnames; i++)
+			batch.files[i].path = names[i];
+		countBatch(&batch, nthreads);
+		num = 0;
+		for(i=0; i<nnames; i++)
+		{
+			if(batch.files[i].words < 0)
+				printf("%s: Error reading file.\n", names[i]);
+			else
+			{
+				printf("%s: %ld total words\n", names[i], batch.files[i].words);
+				num += batch.files[i].words;
+			}
+		}
+		printf("%ld total words\n", num);
+		free(batch.files);
+	}
+	else
+	{
+		num = countFile(argv[1], mflag, nthreads, cache);
+		if(num < 0)
+		{
+			printf("Error reading file.\n");
+			status = 1;
+		}
+		else
+		{
+			//Show counter
+			printf("%ld total words\n",num);
+		}
+	}
+	//Every mode ends here, so the cache is always written and the list freed
+	if(cache != NULL)
+		destroyCache(cache);
+	if(list != NULL)
+	{
+		for(i=0; i<nnames; i++)
+			free(names[i]);
+		free(names);
+	}
+	return status;
 }
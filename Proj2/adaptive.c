@@ -0,0 +1,378 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+#include "set.h"
+#include "hash.h"
+
+#ifndef PROMOTE_THRESHOLD
+#define PROMOTE_THRESHOLD 64 /* Most elements kept in an unsorted array */
+#endif
+
+#define MIN_LENGTH 8 /* Length of array of a new set, a power of two */
+
+struct set
+{
+	int count; /* number of elements */
+	int length; /* length of array or table, a power of two */
+	char ** data; /* array strings, or table of strings once promoted */
+	unsigned *hash; /* hash of each string, kept in step with data */
+	char *flag; /* flag of each slot in table, or NULL while still an array */
+};
+
+typedef struct set SET;
+
+static int scan (SET *sp, char *elt, unsigned hash);
+static int probe (SET *sp, char *elt, unsigned hash, bool *found);
+static void rehash (SET *sp, int length);
+static void shift (SET *sp, int hole);
+static unsigned mix (unsigned hash);
+
+/*
+ * Function Name: createSet
+ * Time Complexity: O(1)
+ * Description: Create a new set as a small unsorted array; it grows as needed, so maxElts is not used
+ */
+SET *createSet (int maxElts)
+{
+	SET *sp;
+	/* Allocate memory for set, assert set has memory */
+	sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	/* Initialize counter and length */
+	sp -> count = 0;
+	sp -> length = MIN_LENGTH;
+	/* Allocate data, assert data has memory */
+	sp -> data = malloc(sizeof(char *) * sp->length);
+	assert(sp -> data != NULL);
+	sp -> hash = malloc(sizeof(unsigned) * sp->length);
+	assert(sp -> hash != NULL);
+	sp -> flag = NULL;
+	return sp;
+}
+
+/*
+ * Function Name: destroySet
+ * Time Complexity: O(n)
+ * Description: Free a previously created set
+ */
+void destroySet (SET *sp)
+{
+	assert(sp != NULL);
+	int i;
+	/* Free data, only filled slots if a table */
+	if(sp->flag == NULL)
+	{
+		for(i=0; i<sp->count; i++)
+			free(sp->data[i]);
+	}
+	else
+	{
+		for(i=0; i<sp->length; i++)
+			if(sp->flag[i] == 'F')
+				free(sp->data[i]);
+		free(sp->flag);
+	}
+	/* Free arrays */
+	free(sp->data);
+	free(sp->hash);
+	/* Free set */
+	free(sp);
+}
+
+/*
+ * Function Name: numElements
+ * Time Complexity: O(1)
+ * Description: Return number of elements given a valid set
+ */
+int numElements (SET *sp)
+{
+	assert(sp != NULL);
+	return sp->count;
+}
+
+/*
+ * Function Name: addElement
+ * Time Complexity: O(n) while an array, O(1) average once a table
+ * Description: Add an element to the set. The array doubles when full, and is
+ * 	promoted to a hash table once it holds more than PROMOTE_THRESHOLD elements.
+ * 	The table doubles once it is 3/4 full.
+ */
+void addElement (SET *sp, char *elt)
+{
+	/* Assert ability to add string to set */
+	assert((elt != NULL) && (sp != NULL));
+	char *NewElt;
+	unsigned hash = mix(strhash(elt));
+	int posn = 0;
+	bool found;
+	if(sp->flag == NULL)
+	{
+		/* Add to end of array if not found */
+		if(scan(sp, elt, hash) != -1)
+			return;
+		if(sp->count == PROMOTE_THRESHOLD)
+			rehash(sp, MIN_LENGTH * 2);
+		else
+		{
+			if(sp->count == sp->length)
+				rehash(sp, sp->length * 2);
+			posn = sp->count;
+		}
+	}
+	if(sp->flag != NULL)
+	{
+		posn = probe(sp, elt, hash, &found);
+		if(found)
+			return;
+		/* Make room so the table stays at most 3/4 full */
+		if(sp->count + 1 > sp->length / 4 * 3)
+		{
+			rehash(sp, sp->length * 2);
+			posn = probe(sp, elt, hash, &found);
+		}
+		sp->flag[posn] = 'F';
+	}
+	/* Make sure element has memory, add element, increment counter */
+	NewElt = strdup(elt);
+	assert(NewElt != NULL);
+	sp->data[posn] = NewElt;
+	sp->hash[posn] = hash;
+	sp->count++;
+}
+
+/*
+ * Function Name: addElements
+ * Time Complexity: O(m) average once a table
+ * Description: Add a batch of elements to the set, one at a time
+ */
+void addElements (SET *sp, char **elts, int n)
+{
+	assert((sp != NULL) && ((elts != NULL) || (n == 0)));
+	int i;
+	for(i=0; i<n; i++)
+		addElement(sp, elts[i]);
+}
+
+/*
+ * Function Name: removeElement
+ * Time Complexity: O(n) while an array, O(1) average once a table
+ * Description: Remove an element from the set if it is there. In a table the elements
+ * 	after it are shifted back to fill its slot, so no deleted marker is left behind.
+ */
+void removeElement (SET *sp, char *elt)
+{
+	/* Assert ability to remove element from set */
+	assert((sp != NULL) && (elt != NULL));
+	unsigned hash = mix(strhash(elt));
+	int locn;
+	bool found;
+	if(sp->flag == NULL)
+	{
+		/* Free element, move last element to empty space, decrement counter */
+		locn = scan(sp, elt, hash);
+		if(locn != -1)
+		{
+			free(sp->data[locn]);
+			sp->count--;
+			sp->data[locn] = sp->data[sp->count];
+			sp->hash[locn] = sp->hash[sp->count];
+		}
+		return;
+	}
+	/* Free element, fill its slot, decrement counter */
+	locn = probe(sp, elt, hash, &found);
+	if(found)
+	{
+		free(sp->data[locn]);
+		shift(sp, locn);
+		sp->count--;
+	}
+}
+
+/*
+ * Function Name: findElement
+ * Time Complexity: O(n) while an array, O(1) average once a table
+ * Description: Find a element in a set and return the pointer to the one in the set
+ */
+char * findElement (SET *sp, char *elt)
+{
+	/* Assert ability to search for element */
+	assert((sp != NULL) && (elt != NULL));
+	unsigned hash = mix(strhash(elt));
+	int locn;
+	bool found;
+	if(sp->flag == NULL)
+		locn = scan(sp, elt, hash);
+	else
+	{
+		locn = probe(sp, elt, hash, &found);
+		if(!found)
+			locn = -1;
+	}
+	/* Return NULL if not found */
+	if(locn == -1)
+		return NULL;
+	return sp->data[locn];
+}
+
+/*
+ * Function Name: getElements
+ * Time Complexity: O(n)
+ * Description: Create a soft copy of the set
+ */
+char ** getElements (SET *sp)
+{
+	/* Assert ability to get elements */
+	assert(sp != NULL);
+	/* Create memory for copy, assert copy has memory*/
+	char ** DataCopy;
+	DataCopy = malloc(sizeof(char *) * (sp->count + 1));
+	assert(DataCopy != NULL);
+	int i, j;
+	if(sp->flag == NULL)
+		memcpy(DataCopy, sp->data, sizeof(char *) * sp->count);
+	else
+		for(i=0, j=0; i<sp->length; i++) /* Pack filled slots to the front */
+			if(sp->flag[i] == 'F')
+				DataCopy[j++] = sp->data[i];
+	return DataCopy;
+}
+
+/*
+ * Function Name: scan
+ * Time Complexity: O(n)
+ * Description: Utility function; Use sequential search of the array to return location of element,
+ * 	return -1 if element is not there. Strings are only compared when their hashes match.
+ */
+static int scan (SET *sp, char *elt, unsigned hash)
+{
+	int i;
+	for(i=0; i<sp->count; i++)
+		if(sp->hash[i] == hash && strcmp(sp->data[i], elt) == 0)
+			return i;
+	return -1;
+}
+
+/*
+ * Function Name: probe
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Utility function; Search the table using linear probing, finding slots with a
+ * 	mask since the length is a power of two. Return index if found, else return the empty
+ * 	index where element would be inserted. The table is never full, so an empty slot always
+ * 	ends the search. Use a pass-by-reference variable to tell client if the element is found.
+ */
+static int probe (SET *sp, char *elt, unsigned hash, bool *found)
+{
+	int mask = sp->length - 1;
+	int locn = hash & mask;
+	while(sp->flag[locn] != 'E')
+	{
+		if(sp->hash[locn] == hash && strcmp(sp->data[locn], elt) == 0)
+		{
+			*found = true;
+			return locn;
+		}
+		locn = (locn + 1) & mask;
+	}
+	*found = false;
+	return locn;
+}
+
+/*
+ * Function Name: rehash
+ * Time Complexity: O(n)
+ * Description: Utility function; Move the elements into new arrays of the given length.
+ * 	A set with more than PROMOTE_THRESHOLD elements, or one that is already a table,
+ * 	becomes a table. The hashes are kept, so no string is rehashed.
+ */
+static void rehash (SET *sp, int length)
+{
+	char **data = sp->data;
+	unsigned *hash = sp->hash;
+	char *flag = sp->flag;
+	int oldLength = sp->length;
+	int i, locn;
+	bool table = flag != NULL || sp->count >= PROMOTE_THRESHOLD;
+	/* Table must have room for one more element at 3/4 full */
+	while(table && sp->count + 1 > length / 4 * 3)
+		length *= 2;
+	sp->length = length;
+	sp->data = malloc(sizeof(char *) * length);
+	assert(sp->data != NULL);
+	sp->hash = malloc(sizeof(unsigned) * length);
+	assert(sp->hash != NULL);
+	if(!table)
+	{
+		/* Still an array, so copy it over */
+		memcpy(sp->data, data, sizeof(char *) * sp->count);
+		memcpy(sp->hash, hash, sizeof(unsigned) * sp->count);
+		free(data);
+		free(hash);
+		return;
+	}
+	sp->flag = malloc(sizeof(char) * length);
+	assert(sp->flag != NULL);
+	memset(sp->flag, 'E', length);
+	/* Insert each filled slot, or every element of an array, into an empty slot */
+	for(i=0; i<(flag == NULL ? sp->count : oldLength); i++)
+	{
+		if(flag != NULL && flag[i] != 'F')
+			continue;
+		locn = hash[i] & (length - 1);
+		while(sp->flag[locn] != 'E')
+			locn = (locn + 1) & (length - 1);
+		sp->data[locn] = data[i];
+		sp->hash[locn] = hash[i];
+		sp->flag[locn] = 'F';
+	}
+	free(data);
+	free(hash);
+	free(flag);
+}
+
+/*
+ * Function Name: shift
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Utility function; Empty the slot at hole, moving back each later element in
+ * 	its run that may live there, so every element stays reachable from its home slot
+ * 	without gaps. Each element moved leaves a new hole behind it, until the run ends.
+ */
+static void shift (SET *sp, int hole)
+{
+	int mask = sp->length - 1;
+	int locn = hole;
+	int home;
+	while(1)
+	{
+		locn = (locn + 1) & mask;
+		if(sp->flag[locn] == 'E') /* End of run */
+			break;
+		home = sp->hash[locn] & mask;
+		/* Move back only if hole lies between home and locn */
+		if(((locn - home) & mask) >= ((locn - hole) & mask))
+		{
+			sp->data[hole] = sp->data[locn];
+			sp->hash[hole] = sp->hash[locn];
+			hole = locn;
+		}
+	}
+	sp->flag[hole] = 'E';
+}
+
+/*
+ * Function Name: mix
+ * Time Complexity: O(1)
+ * Description: Utility function; Spread the bits of a hash, so that the low bits picking the
+ * 	home slot depend on every bit of the string's hash
+ */
+static unsigned mix (unsigned hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	hash ^= hash >> 16;
+	return hash;
+}
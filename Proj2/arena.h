@@ -0,0 +1,27 @@
+/*
+ * File:        arena.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for an arena of strings.  Strings are copied
+ *              into large chunks one after another and are all freed at
+ *              once when the arena is destroyed.
+ */
+
+# ifndef ARENA_H
+# define ARENA_H
+
+# include <stdbool.h>
+
+typedef struct arena ARENA;
+
+ARENA *createArena(void);
+
+void destroyArena(ARENA *ap);
+
+char *copyString(ARENA *ap, char *s);
+
+void releaseString(ARENA *ap, char *s);
+
+bool needsCompaction(ARENA *ap);
+
+# endif /* ARENA_H */
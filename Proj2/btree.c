@@ -0,0 +1,457 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+#include "set.h"
+
+#define T 32 /* Minimum degree: every node but the root holds T-1 to 2T-1 strings */
+
+struct node
+{
+	int count; /* number of strings */
+	bool leaf; /* true if node has no children */
+	char *data[2*T-1]; /* sorted strings */
+	struct node *child[]; /* count+1 children, only allocated for internal nodes */
+};
+
+typedef struct node NODE;
+
+struct set
+{
+	int count; /* number of elements */
+	NODE *root; /* root of tree */
+};
+
+typedef struct set SET;
+
+static NODE *createNode (bool leaf);
+static int search (NODE *np, char *elt, bool *found);
+static void split (NODE *np, int i);
+static void insert (NODE *np, char *elt);
+static void delete (NODE *np, char *elt);
+static void merge (NODE *np, int i);
+static void freeNode (NODE *np);
+static int walk (NODE *np, char **elts, int n);
+
+/*
+ * Function Name: createSet
+ * Time Complexity: O(1)
+ * Description: Create a new set; the tree grows as needed, so maxElts is not used
+ */
+SET *createSet (int maxElts)
+{
+	SET *sp;
+	/* Allocate memory for set, assert set has memory */
+	sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	/* Start with an empty leaf as the root */
+	sp -> count = 0;
+	sp -> root = createNode(true);
+	return sp;
+}
+
+/*
+ * Function Name: destroySet
+ * Time Complexity: O(n)
+ * Description: Free a previously created set
+ */
+void destroySet (SET *sp)
+{
+	assert(sp != NULL);
+	freeNode(sp->root);
+	free(sp);
+}
+
+/*
+ * Function Name: numElements
+ * Time Complexity: O(1)
+ * Description: Return number of elements given a valid set
+ */
+int numElements (SET *sp)
+{
+	assert(sp != NULL);
+	return sp->count;
+}
+
+/*
+ * Function Name: addElement
+ * Time Complexity: O(log(n))
+ * Description: Add an element to the set if it is not already there.
+ * 	A full root is split first, so the tree only grows at the top.
+ */
+void addElement (SET *sp, char *elt)
+{
+	assert((elt != NULL) && (sp != NULL));
+	char *NewElt;
+	NODE *root;
+	/* Nothing to do if already there */
+	if(findElement(sp, elt) != NULL)
+		return;
+	/* Make sure element has memory */
+	NewElt = strdup(elt);
+	assert(NewElt != NULL);
+	/* Split a full root under a new root */
+	if(sp->root->count == 2*T-1)
+	{
+		root = createNode(false);
+		root->child[0] = sp->root;
+		sp->root = root;
+		split(root, 0);
+	}
+	insert(sp->root, NewElt);
+	sp->count++;
+}
+
+/*
+ * Function Name: addElements
+ * Time Complexity: O(m log(n))
+ * Description: Add a batch of elements to the set, one at a time
+ */
+void addElements (SET *sp, char **elts, int n)
+{
+	assert((sp != NULL) && ((elts != NULL) || (n == 0)));
+	int i;
+	for(i=0; i<n; i++)
+		addElement(sp, elts[i]);
+}
+
+/*
+ * Function Name: removeElement
+ * Time Complexity: O(log(n))
+ * Description: Remove an element from the set if it is there
+ */
+void removeElement (SET *sp, char *elt)
+{
+	assert((sp != NULL) && (elt != NULL));
+	char *OldElt;
+	NODE *root;
+	/* Find the copy to free once it is out of the tree */
+	OldElt = findElement(sp, elt);
+	if(OldElt == NULL)
+		return;
+	delete(sp->root, elt);
+	free(OldElt);
+	sp->count--;
+	/* An empty internal root is replaced by its only child */
+	root = sp->root;
+	if(root->count == 0 && !root->leaf)
+	{
+		sp->root = root->child[0];
+		free(root);
+	}
+}
+
+/*
+ * Function Name: findElement
+ * Time Complexity: O(log(n))
+ * Description: Find a element in a set and return the pointer to the one in the set
+ */
+char * findElement (SET *sp, char *elt)
+{
+	assert((sp != NULL) && (elt != NULL));
+	NODE *np = sp->root;
+	int locn;
+	bool found;
+	/* Binary search each node on the way down */
+	while(1)
+	{
+		locn = search(np, elt, &found);
+		if(found)
+			return np->data[locn];
+		if(np->leaf)
+			return NULL;
+		np = np->child[locn];
+	}
+}
+
+/*
+ * Function Name: getElements
+ * Time Complexity: O(n)
+ * Description: Create a soft copy of the set in sorted order
+ */
+char ** getElements (SET *sp)
+{
+	/* Assert ability to get elements */
+	assert(sp != NULL);
+	/* Create memory for copy, assert copy has memory*/
+	char ** DataCopy;
+	DataCopy = malloc(sizeof(char *) * (sp->count + 1));
+	assert(DataCopy != NULL);
+	/* Fill copy with an in-order walk */
+	walk(sp->root, DataCopy, 0);
+	return DataCopy;
+}
+
+/*
+ * Function Name: createNode
+ * Time Complexity: O(1)
+ * Description: Utility function; Allocate an empty node, with room for children if not a leaf
+ */
+static NODE *createNode (bool leaf)
+{
+	NODE *np;
+	size_t size = offsetof(NODE, child);
+	if(!leaf)
+		size += sizeof(NODE *) * 2*T;
+	np = malloc(size);
+	assert(np != NULL);
+	np->count = 0;
+	np->leaf = leaf;
+	return np;
+}
+
+/*
+ * Function Name: search
+ * Time Complexity: O(log(T))
+ * Description: Utility function; Use binary search in one node to return location of element,
+ * 	or the child to descend into if it is not there, and if the element is found
+ */
+static int search (NODE *np, char *elt, bool *found)
+{
+	/* Initialize variables */
+	int lo,hi,mid,diff;
+	lo = 0;
+	hi = np->count-1;
+	/* Loop for binary search */
+	while(lo <= hi){
+		mid = (lo+hi)/2;
+		/* Compare middle element with elt, then change bounds*/
+		diff = strcmp(elt,np->data[mid]);
+		if(diff < 0)
+			hi = mid - 1;
+		else if (diff > 0)
+			lo = mid + 1;
+		else {
+			*found = true;
+			return mid;
+		}
+	}
+	*found = false;
+	return lo;
+}
+
+/*
+ * Function Name: split
+ * Time Complexity: O(T)
+ * Description: Utility function; Split the full child i of a node that is not full.
+ * 	The upper T-1 strings move to a new sibling and the median moves up.
+ */
+static void split (NODE *np, int i)
+{
+	NODE *left = np->child[i];
+	NODE *right = createNode(left->leaf);
+	/* Move upper half to new right sibling */
+	right->count = T-1;
+	memcpy(right->data, left->data + T, sizeof(char *) * (T-1));
+	if(!left->leaf)
+		memcpy(right->child, left->child + T, sizeof(NODE *) * T);
+	left->count = T-1;
+	/* Make room in parent for median and new child */
+	memmove(np->data + i + 1, np->data + i, sizeof(char *) * (np->count - i));
+	memmove(np->child + i + 2, np->child + i + 1, sizeof(NODE *) * (np->count - i));
+	np->data[i] = left->data[T-1];
+	np->child[i+1] = right;
+	np->count++;
+}
+
+/*
+ * Function Name: insert
+ * Time Complexity: O(log(n))
+ * Description: Utility function; Insert a new string below a node that is not full,
+ * 	splitting full children on the way down so there is always room
+ */
+static void insert (NODE *np, char *elt)
+{
+	int i;
+	bool found;
+	while(!np->leaf)
+	{
+		i = search(np, elt, &found);
+		if(np->child[i]->count == 2*T-1)
+		{
+			split(np, i);
+			if(strcmp(elt, np->data[i]) > 0)
+				i++;
+		}
+		np = np->child[i];
+	}
+	/* Shift larger strings right and insert */
+	i = search(np, elt, &found);
+	memmove(np->data + i + 1, np->data + i, sizeof(char *) * (np->count - i));
+	np->data[i] = elt;
+	np->count++;
+}
+
+/*
+ * Function Name: merge
+ * Time Complexity: O(T)
+ * Description: Utility function; Merge child i+1 and the string between them into child i.
+ * 	Both children must hold T-1 strings.
+ */
+static void merge (NODE *np, int i)
+{
+	NODE *left = np->child[i];
+	NODE *right = np->child[i+1];
+	/* Pull separator down, then append right sibling */
+	left->data[T-1] = np->data[i];
+	memcpy(left->data + T, right->data, sizeof(char *) * right->count);
+	if(!left->leaf)
+		memcpy(left->child + T, right->child, sizeof(NODE *) * (right->count + 1));
+	left->count += right->count + 1;
+	free(right);
+	/* Close the gap in parent */
+	memmove(np->data + i, np->data + i + 1, sizeof(char *) * (np->count - i - 1));
+	memmove(np->child + i + 1, np->child + i + 2, sizeof(NODE *) * (np->count - i - 1));
+	np->count--;
+}
+
+/*
+ * Function Name: fill
+ * Time Complexity: O(T)
+ * Description: Utility function; Make sure child i of a node holds at least T strings
+ * 	by borrowing through the parent from a sibling, or by merging with one.
+ * 	Return the index of the child that now covers the same range.
+ */
+static int fill (NODE *np, int i)
+{
+	NODE *c = np->child[i];
+	NODE *s;
+	if(i > 0 && np->child[i-1]->count >= T)
+	{
+		/* Rotate last string of left sibling through parent */
+		s = np->child[i-1];
+		memmove(c->data + 1, c->data, sizeof(char *) * c->count);
+		if(!c->leaf)
+		{
+			memmove(c->child + 1, c->child, sizeof(NODE *) * (c->count + 1));
+			c->child[0] = s->child[s->count];
+		}
+		c->data[0] = np->data[i-1];
+		np->data[i-1] = s->data[s->count-1];
+		s->count--;
+		c->count++;
+	}
+	else if(i < np->count && np->child[i+1]->count >= T)
+	{
+		/* Rotate first string of right sibling through parent */
+		s = np->child[i+1];
+		c->data[c->count] = np->data[i];
+		if(!c->leaf)
+			c->child[c->count+1] = s->child[0];
+		np->data[i] = s->data[0];
+		memmove(s->data, s->data + 1, sizeof(char *) * (s->count - 1));
+		if(!s->leaf)
+			memmove(s->child, s->child + 1, sizeof(NODE *) * s->count);
+		s->count--;
+		c->count++;
+	}
+	else
+	{
+		/* Both siblings are minimal, so merge with one */
+		if(i == np->count)
+			i--;
+		merge(np, i);
+	}
+	return i;
+}
+
+/*
+ * Function Name: delete
+ * Time Complexity: O(log(n))
+ * Description: Utility function; Remove a string from the subtree of a node holding
+ * 	at least T strings (or the root), without freeing it. Every child descended
+ * 	into is first given T strings, so no node underflows on the way back.
+ */
+static void delete (NODE *np, char *elt)
+{
+	int i;
+	bool found;
+	NODE *left, *right;
+	char *replace;
+	while(1)
+	{
+		i = search(np, elt, &found);
+		if(found && np->leaf)
+		{
+			/* Remove from leaf and close the gap */
+			memmove(np->data + i, np->data + i + 1, sizeof(char *) * (np->count - i - 1));
+			np->count--;
+			return;
+		}
+		if(found)
+		{
+			left = np->child[i];
+			right = np->child[i+1];
+			if(left->count >= T)
+			{
+				/* Replace with predecessor, then remove predecessor below */
+				while(!left->leaf)
+					left = left->child[left->count];
+				replace = left->data[left->count-1];
+				np->data[i] = replace;
+				elt = replace;
+				np = np->child[i];
+			}
+			else if(right->count >= T)
+			{
+				/* Replace with successor, then remove successor below */
+				while(!right->leaf)
+					right = right->child[0];
+				replace = right->data[0];
+				np->data[i] = replace;
+				elt = replace;
+				np = np->child[i+1];
+			}
+			else
+			{
+				/* Merge both children around the string and remove it there */
+				merge(np, i);
+				np = left;
+			}
+			continue;
+		}
+		if(np->leaf)
+			return;
+		if(np->child[i]->count < T)
+			i = fill(np, i);
+		np = np->child[i];
+	}
+}
+
+/*
+ * Function Name: freeNode
+ * Time Complexity: O(n)
+ * Description: Utility function; Free the strings and nodes in a subtree
+ */
+static void freeNode (NODE *np)
+{
+	int i;
+	for(i=0; i<np->count; i++)
+		free(np->data[i]);
+	if(!np->leaf)
+		for(i=0; i<=np->count; i++)
+			freeNode(np->child[i]);
+	free(np);
+}
+
+/*
+ * Function Name: walk
+ * Time Complexity: O(n)
+ * Description: Utility function; Store the strings of a subtree in order starting at elts[n],
+ * 	return the index after the last one stored
+ */
+static int walk (NODE *np, char **elts, int n)
+{
+	int i;
+	for(i=0; i<np->count; i++)
+	{
+		if(!np->leaf)
+			n = walk(np->child[i], elts, n);
+		elts[n++] = np->data[i];
+	}
+	if(!np->leaf)
+		n = walk(np->child[np->count], elts, n);
+	return n;
+}
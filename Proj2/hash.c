@@ -0,0 +1,159 @@
+/*
+ * File:        hash.c
+ *
+ * Description: This file contains the public and private function
+ *              definitions for hashing strings.
+ *
+ *              The hash follows wyhash.  The string is read eight bytes
+ *              at a time, and each sixteen bytes are folded into the state
+ *              with a 64 by 64 to 128-bit multiply.  Strings of at most
+ *              sixteen bytes, which is nearly every word, are read with
+ *              two to four overlapping loads and no loop at all.
+ */
+
+# include <stdlib.h>
+# include <string.h>
+# include <stdint.h>
+# include <time.h>
+# include <unistd.h>
+# include <sys/random.h>
+# include "hash.h"
+
+static const uint64_t secret[2] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+};
+
+static uint64_t seed;
+
+
+/*
+ * Function:    mix
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the high and low halves of the 128-bit product of A
+ *		and B folded together.
+ */
+
+static inline uint64_t mix(uint64_t a, uint64_t b)
+{
+    __uint128_t r = (__uint128_t) a * b;
+
+
+    return (uint64_t) r ^ (uint64_t) (r >> 64);
+}
+
+
+/*
+ * Function:    read64, read32
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the eight or four bytes at P, which need not be
+ *		aligned.
+ */
+
+static inline uint64_t read64(const char *p)
+{
+    uint64_t v;
+
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t read32(const char *p)
+{
+    uint32_t v;
+
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+
+/*
+ * Function:    chooseSeed
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Choose the seed before main runs, so that it is never
+ *		chosen by two threads at once.  The seed is taken from
+ *		HASH_SEED if it is set, else from the kernel, else from the
+ *		time and process id.
+ */
+
+__attribute__((constructor))
+static void chooseSeed(void)
+{
+    char *s;
+
+
+    if ((s = getenv("HASH_SEED")) != NULL)
+	seed = strtoull(s, NULL, 0);
+    else if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) != sizeof(seed))
+	seed = (uint64_t) time(NULL) << 32 ^ getpid();
+
+    seed ^= mix(seed ^ secret[0], secret[1]);
+}
+
+
+/*
+ * Function:    strhash64
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return a 64-bit hash value for a string S.
+ */
+
+unsigned long long strhash64(char *s)
+{
+    size_t len, i;
+    uint64_t a, b, state;
+    __uint128_t r;
+    const char *p = s;
+
+
+    len = strlen(s);
+    state = seed;
+
+    if (len <= 16) {
+	if (len >= 4) {
+	    a = read32(p) << 32 | read32(p + (len >> 3 << 2));
+	    b = read32(p + len - 4) << 32 | read32(p + len - 4 - (len >> 3 << 2));
+	} else if (len > 0) {
+	    a = (uint64_t) (unsigned char) p[0] << 16 |
+		(uint64_t) (unsigned char) p[len >> 1] << 8 |
+		(unsigned char) p[len - 1];
+	    b = 0;
+	} else
+	    a = b = 0;
+
+    } else {
+	for (i = len; i > 16; i -= 16, p += 16)
+	    state = mix(read64(p) ^ secret[1], read64(p + 8) ^ state);
+
+	a = read64(p + i - 16);
+	b = read64(p + i - 8);
+    }
+
+    r = (__uint128_t) (a ^ secret[1]) * (b ^ state);
+    a = (uint64_t) r;
+    b = (uint64_t) (r >> 64);
+
+    return mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+
+/*
+ * Function:    strhash
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return a hash value for a string S.
+ */
+
+unsigned strhash(char *s)
+{
+    return strhash64(s);
+}
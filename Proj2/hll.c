@@ -0,0 +1,238 @@
+/*
+ * File:        hll.c
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for a HyperLogLog sketch of strings.
+ *
+ *              Each string is hashed to 64 bits.  The top PRECISION bits
+ *              pick one of 2^PRECISION registers, and the register keeps
+ *              the longest run of leading zeros seen in the remaining bits.
+ *              The harmonic mean of the registers estimates the number of
+ *              distinct strings with a standard error of about
+ *              1.04 / sqrt(2^PRECISION), or 1.6% for 4 KB of registers.
+ */
+
+# include <stdlib.h>
+# include <string.h>
+# include <assert.h>
+# include <math.h>
+# include "hll.h"
+
+# define PRECISION 12
+# define REGISTERS (1 << PRECISION)
+
+# if REGISTERS != HLL_LENGTH
+# error "HLL_LENGTH must match the number of registers"
+# endif
+
+struct hll {
+    unsigned char reg[REGISTERS];	/* longest zero run + 1 per register */
+};
+
+
+/*
+ * Function:    hash64
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return a 64-bit hash value for a string S.  FNV-1a mixes
+ *		the bytes and a final avalanche step spreads them over all
+ *		the bits, since the sketch uses the high and low bits apart.
+ */
+
+static unsigned long long hash64(char *s)
+{
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+
+
+    while (*s != '\0') {
+	hash ^= (unsigned char) *s ++;
+	hash *= 0x100000001b3ULL;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+
+/*
+ * Function:    createHLL
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return a pointer to a new, empty sketch.
+ */
+
+HLL *createHLL(void)
+{
+    HLL *hp;
+
+
+    hp = malloc(sizeof(HLL));
+    assert(hp != NULL);
+
+    memset(hp->reg, 0, sizeof(hp->reg));
+    return hp;
+}
+
+
+/*
+ * Function:    destroyHLL
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Deallocate memory associated with the sketch pointed to by
+ *		HP.
+ */
+
+void destroyHLL(HLL *hp)
+{
+    assert(hp != NULL);
+    free(hp);
+}
+
+
+/*
+ * Function:    addHLL
+ *
+ * Complexity:  O(n) in the length of ELT
+ *
+ * Description: Add ELT to the sketch pointed to by HP.
+ */
+
+void addHLL(HLL *hp, char *elt)
+{
+    unsigned long long hash, rest;
+    int index, rank;
+
+
+    assert(hp != NULL && elt != NULL);
+
+    hash = hash64(elt);
+    index = hash >> (64 - PRECISION);
+    rest = hash << PRECISION;
+    rank = rest == 0 ? 64 - PRECISION + 1 : __builtin_clzll(rest) + 1;
+
+    if (rank > hp->reg[index])
+	hp->reg[index] = rank;
+}
+
+
+/*
+ * Function:    estimateHLL
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Return the estimated number of distinct strings added to
+ *		the sketch pointed to by HP.  Small counts, where many
+ *		registers are still empty, use linear counting instead.
+ */
+
+double estimateHLL(HLL *hp)
+{
+    double sum, estimate, alpha;
+    int i, zeros;
+
+
+    assert(hp != NULL);
+
+    sum = 0;
+    zeros = 0;
+
+    for (i = 0; i < REGISTERS; i ++) {
+	sum += ldexp(1.0, -hp->reg[i]);
+
+	if (hp->reg[i] == 0)
+	    zeros ++;
+    }
+
+    alpha = 0.7213 / (1 + 1.079 / REGISTERS);
+    estimate = alpha * REGISTERS * REGISTERS / sum;
+
+    if (estimate <= 2.5 * REGISTERS && zeros > 0)
+	estimate = REGISTERS * log((double) REGISTERS / zeros);
+
+    return estimate;
+}
+
+
+/*
+ * Function:    mergeHLL
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Add everything in the sketch pointed to by SRC to the
+ *		sketch pointed to by DST, as if the strings had been added
+ *		to DST directly.
+ */
+
+void mergeHLL(HLL *dst, HLL *src)
+{
+    int i;
+
+
+    assert(dst != NULL && src != NULL);
+
+    for (i = 0; i < REGISTERS; i ++)
+	if (src->reg[i] > dst->reg[i])
+	    dst->reg[i] = src->reg[i];
+}
+
+
+/*
+ * Function:    writeHLL
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Write the sketch pointed to by HP into S as HLL_LENGTH
+ *		printable characters, one per register, and a null.
+ */
+
+void writeHLL(HLL *hp, char *s)
+{
+    int i;
+
+
+    assert(hp != NULL && s != NULL);
+
+    for (i = 0; i < REGISTERS; i ++)
+	s[i] = '0' + hp->reg[i];
+
+    s[REGISTERS] = '\0';
+}
+
+
+/*
+ * Function:    readHLL
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Replace the sketch pointed to by HP with one written by
+ *		writeHLL into S.  Return false, leaving the sketch alone,
+ *		if S is not such a string.
+ */
+
+bool readHLL(HLL *hp, char *s)
+{
+    int i;
+
+
+    assert(hp != NULL && s != NULL);
+
+    if (strlen(s) != REGISTERS)
+	return false;
+
+    for (i = 0; i < REGISTERS; i ++)
+	if (s[i] < '0' || s[i] > '0' + 64 - PRECISION + 1)
+	    return false;
+
+    for (i = 0; i < REGISTERS; i ++)
+	hp->reg[i] = s[i] - '0';
+
+    return true;
+}
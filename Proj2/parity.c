@@ -16,6 +16,7 @@
 # include <stdlib.h>
 # include <string.h>
 # include "set.h"
+# include "reader.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
@@ -32,7 +33,8 @@
 int main(int argc, char *argv[])
 {
     FILE *fp;
-    char buffer[BUFSIZ];
+    READER *rp;
+    char *buffer;
     SET *odd;
     int words;
 
@@ -54,8 +56,9 @@ int main(int argc, char *argv[])
 
     words = 0;
     odd = createSet(MAX_SIZE);
+    rp = createReader(fp);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
+    while ((buffer = readWord(rp, NULL)) != NULL) {
         words ++;
 
         if (findElement(odd, buffer))
@@ -66,6 +69,7 @@ int main(int argc, char *argv[])
 
     printf("%d total words\n", words);
     printf("%d words occur an odd number of times\n", numElements(odd));
+    destroyReader(rp);
     fclose(fp);
 
     destroySet(odd);
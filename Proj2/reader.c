@@ -0,0 +1,179 @@
+/*
+ * File:        reader.c
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for a word reader.
+ *
+ *              The file is read in large blocks.  Each word is terminated
+ *              in place by overwriting the whitespace after it, so reading
+ *              a word costs no copying and no allocation.  A word that
+ *              does not fit in the buffer makes the buffer grow, so there
+ *              is no limit on the length of a word.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <ctype.h>
+# include <assert.h>
+# include <stdbool.h>
+# include "reader.h"
+
+# define BLOCK_SIZE 65536
+
+struct reader {
+    FILE *fp;			/* file being read                 */
+    char *buffer;		/* holds size bytes plus a null    */
+    int size;			/* bytes the buffer can hold       */
+    int start;			/* first byte not yet returned     */
+    int end;			/* one past the last byte read     */
+    bool eof;			/* true once fread hits the end    */
+};
+
+
+/*
+ * Function:    fill
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Keep the unread bytes of the reader pointed to by RP, move
+ *		them to the front of the buffer, and read more after them.
+ *		The buffer is doubled first if it is already full.
+ */
+
+static void fill(READER *rp)
+{
+    int n;
+
+
+    if (rp->start > 0) {
+	memmove(rp->buffer, rp->buffer + rp->start, rp->end - rp->start);
+	rp->end -= rp->start;
+	rp->start = 0;
+    }
+
+    if (rp->end == rp->size) {
+	rp->size *= 2;
+	rp->buffer = realloc(rp->buffer, rp->size + 1);
+	assert(rp->buffer != NULL);
+    }
+
+    n = fread(rp->buffer + rp->end, 1, rp->size - rp->end, rp->fp);
+    rp->end += n;
+
+    if (n == 0)
+	rp->eof = true;
+}
+
+
+/*
+ * Function:    createReader
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return a pointer to a new reader for the open file FP.  The
+ *		caller still owns FP and must close it.
+ */
+
+READER *createReader(FILE *fp)
+{
+    READER *rp;
+
+
+    assert(fp != NULL);
+
+    rp = malloc(sizeof(READER));
+    assert(rp != NULL);
+
+    rp->size = BLOCK_SIZE;
+    rp->buffer = malloc(rp->size + 1);
+    assert(rp->buffer != NULL);
+
+    rp->fp = fp;
+    rp->start = 0;
+    rp->end = 0;
+    rp->eof = false;
+
+    return rp;
+}
+
+
+/*
+ * Function:    destroyReader
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Deallocate memory associated with the reader pointed to by
+ *		RP.  Words it returned are no longer valid.
+ */
+
+void destroyReader(READER *rp)
+{
+    assert(rp != NULL);
+
+    free(rp->buffer);
+    free(rp);
+}
+
+
+/*
+ * Function:    readWord
+ *
+ * Complexity:  O(n) in the length of the word
+ *
+ * Description: Return the next word from the reader pointed to by RP, or
+ *		NULL at the end of the file.  If LEN is not NULL then the
+ *		length of the word is stored there.  The word is null
+ *		terminated and stays valid until the next call.
+ */
+
+char *readWord(READER *rp, int *len)
+{
+    int i;
+    char *word;
+
+
+    assert(rp != NULL);
+
+
+    /* Skip whitespace, reading more as needed. */
+
+    while (1) {
+	while (rp->start < rp->end && isspace((unsigned char) rp->buffer[rp->start]))
+	    rp->start ++;
+
+	if (rp->start < rp->end)
+	    break;
+
+	if (rp->eof)
+	    return NULL;
+
+	fill(rp);
+    }
+
+
+    /* Find the end of the word, reading more if it runs off the buffer. */
+
+    i = rp->start;
+
+    while (1) {
+	while (i < rp->end && !isspace((unsigned char) rp->buffer[i]))
+	    i ++;
+
+	if (i < rp->end || rp->eof)
+	    break;
+
+	i -= rp->start;
+	fill(rp);
+	i += rp->start;
+    }
+
+    word = rp->buffer + rp->start;
+    rp->buffer[i] = '\0';
+
+    if (len != NULL)
+	*len = i - rp->start;
+
+    rp->start = i < rp->end ? i + 1 : i;
+    return word;
+}
@@ -21,6 +21,8 @@ int numElements(SET *sp);
 
 void addElement(SET *sp, char *elt);
 
+void addElements(SET *sp, char **elts, int n);
+
 void removeElement(SET *sp, char *elt);
 
 char *findElement(SET *sp, char *elt);
@@ -3,18 +3,53 @@
 #include <string.h>
 #include <assert.h>
 #include <stdbool.h>
-#include "set.h"
+#include <stdint.h>
+#include "sorted.h"
+#include "arena.h"
+
+#define BLOCK 16 /* Strings per front coded block */
+#define GALLOP 8 /* Size ratio of two sets above which merges gallop */
+
+#define ONLY_A 1 /* Keep elements only in first set of merge */
+#define BOTH 2 /* Keep elements in both sets of merge */
+#define ONLY_B 4 /* Keep elements only in second set of merge */
 
 struct set 
 {
 	int count; /* number of elements */
 	int length; /* length of array */
 	char ** data; /* array strings */
+	unsigned long long *prefix; /* first 8 bytes of each string, kept in step with data */
+	unsigned long long *tree; /* prefixes in Eytzinger order, built for repeated finds */
+	int *order; /* index in data of each node in tree */
+	int finds; /* finds since the set last changed */
+	bool built; /* true if tree matches data */
+	char *packed; /* front coded strings when compressed, else NULL */
+	int *blocks; /* offset in packed of each block */
+	int nblocks; /* number of blocks */
+	char *scratch; /* string decoded by the last find when compressed */
+	char *expanded; /* strings decoded by the last getElements when compressed */
+	size_t size; /* total length of strings with their terminators */
+	ARENA *arena; /* storage for the strings, unless compressed */
 };
 
 typedef struct set SET;
 
 static int search (SET *sp, char *elt, bool *found);
+static int lookup (SET *sp, char *elt);
+static void build (SET *sp);
+static int layout (SET *sp, int i, int k);
+static unsigned long long prefix (char *s);
+static void changed (SET *sp);
+static int compare (const void *a, const void *b);
+static char *unpack (SET *sp, char *elt);
+static char *decode (char *p, char *s, bool head);
+static void thaw (SET *sp);
+static SET *merge (SET *a, SET *b, int keep);
+static int gallop (SET *sp, int lo, char *elt);
+static void append (SET *dst, SET *src, int lo, int hi);
+static int bound (SET *sp, char *elt, size_t len, bool after);
+static void compact (SET *sp);
 
 /*
  * Function Name: createSet
@@ -33,6 +68,15 @@ SET *createSet (int maxElts)
 	/* Allocate data, assert data has memory */
 	sp ->data = malloc(sizeof(char *) * maxElts);
 	assert(sp ->data != NULL);
+	sp ->prefix = malloc(sizeof(unsigned long long) * maxElts);
+	assert(sp ->prefix != NULL);
+	/* Search tree is only allocated once it is needed */
+	sp ->tree = NULL;
+	sp ->order = NULL;
+	sp ->packed = NULL;
+	sp ->expanded = NULL;
+	sp ->arena = createArena();
+	changed(sp);
 	return sp;
 }
 
@@ -43,12 +87,20 @@ SET *createSet (int maxElts)
  */
 void destroySet (SET *sp)
 {
-	int i;
-	/* Free data */
-	for(i=0; i<sp->count; i++)
-		free(sp->data[i]);
-	/* Free array */
+	/* Free data, which is only front coded strings if compressed */
+	if(sp->packed != NULL)
+	{
+		free(sp->packed);
+		free(sp->blocks);
+		free(sp->scratch);
+		free(sp->expanded);
+	}
+	destroyArena(sp->arena);
+	/* Free arrays */
 	free(sp->data);
+	free(sp->prefix);
+	free(sp->tree);
+	free(sp->order);
 	/* Free set */
 	free(sp);
 }
@@ -77,25 +129,93 @@ void addElement (SET *sp, char *elt)
 	int posn;
 	int i;
 	bool found;
+	/* Thaw a compressed set only if it will change */
+	if(sp->packed != NULL)
+	{
+		if(unpack(sp, elt) != NULL)
+			return;
+		thaw(sp);
+	}
 	/* Search for new element */
 	posn = search(sp, elt,&found);
 	/* Add if not found*/
 	if(!found)
 	{
-		/* Make sure element has memory, add element, increment counter */
-		NewElt = strdup(elt);
-		assert(NewElt != NULL);
+		/* Copy element into the arena, add element, increment counter */
+		NewElt = copyString(sp->arena, elt);
 		for(i=sp->count;i>posn;i--)
+		{
 			sp->data[i] = sp->data[i-1];
+			sp->prefix[i] = sp->prefix[i-1];
+		}
 		sp->data[posn] = NewElt;
+		sp->prefix[posn] = prefix(NewElt);
 		sp->count++;
+		changed(sp);
 	}
 }
 
+/*
+ * Function Name: addElements
+ * Time Complexity: O(m log(m) + n)
+ * Description: Add a batch of m elements at once. The batch is sorted and
+ * 	the duplicates dropped, then it is merged into the set in one pass
+ * 	from the back, so no element of the set moves more than once.
+ */
+void addElements (SET *sp, char **elts, int n)
+{
+	/* Assert ability to add strings to set */
+	assert((sp != NULL) && ((elts != NULL) || (n == 0)));
+	char **batch;
+	char *NewElt;
+	int i,j,k,m,diff;
+	if(n == 0)
+		return;
+	thaw(sp);
+	/* Sort a copy of the batch */
+	batch = malloc(sizeof(char *) * n);
+	assert(batch != NULL);
+	memcpy(batch, elts, sizeof(char *) * n);
+	qsort(batch, n, sizeof(char *), compare);
+	/* Keep only strings that are new to the batch and to the set */
+	for(i=0, j=0, m=0; j<n; j++)
+	{
+		if(m > 0 && strcmp(batch[j], batch[m-1]) == 0)
+			continue;
+		diff = 1;
+		while(i < sp->count && (diff = strcmp(sp->data[i], batch[j])) < 0)
+			i++;
+		if(diff != 0)
+			batch[m++] = batch[j];
+	}
+	/* Merge from the back, largest first */
+	assert(sp->count + m <= sp->length);
+	i = sp->count - 1;
+	k = sp->count + m - 1;
+	for(j=m-1; j>=0; j--)
+	{
+		while(i >= 0 && strcmp(sp->data[i], batch[j]) > 0)
+		{
+			sp->prefix[k] = sp->prefix[i];
+			sp->data[k--] = sp->data[i--];
+		}
+		/* Copy element into the arena */
+		NewElt = copyString(sp->arena, batch[j]);
+		sp->prefix[k] = prefix(NewElt);
+		sp->data[k--] = NewElt;
+	}
+	sp->count += m;
+	if(m > 0)
+		changed(sp);
+	free(batch);
+}
+
 /* 
  * Function Name: removeElement
  * Time Complexity: O(n)
- * Description: Remove an element and keep rest of elements sorted in the set
+ * Description: Remove an element and keep rest of elements sorted in the set. Once most
+ * 	of the arena is released strings, the rest are compacted into a new one, which
+ * 	moves them, so pointers to elements are only valid until the next removal.
  */
 void removeElement (SET *sp, char *elt)
 {
@@ -104,22 +224,37 @@ void removeElement (SET *sp, char *elt)
 	int locn;
 	int i;
 	bool found;
+	/* Thaw a compressed set only if it will change */
+	if(sp->packed != NULL)
+	{
+		if(unpack(sp, elt) == NULL)
+			return;
+		thaw(sp);
+	}
 	/* Search for element to delte */
 	locn = search(sp,elt,&found);
 	/* Remove if found */
 	if(found) {
-		/* Free element, move last element to empty space, decrement counter */
-		free(sp->data[locn]);
+		/* Release element, move later elements back, decrement counter */
+		releaseString(sp->arena, sp->data[locn]);
 		for(i=locn+1;i<sp->count;i++)
+		{
 			sp->data[i-1] = sp->data[i];
+			sp->prefix[i-1] = sp->prefix[i];
+		}
 		sp->count--;
+		if(needsCompaction(sp->arena))
+			compact(sp);
+		changed(sp);
 	}
 }
 
 /* 
  * Function Name: findElement
  * Time Complexity: O(log(n))
- * Description: Find a element in a set and return the pointer to the one in the set
+ * Description: Find a element in a set and return the pointer to the one in the set.
+ * 	Once there have been as many finds as elements without a change, the
+ * 	prefixes are laid out as an Eytzinger tree and later finds search that.
  */
 char * findElement (SET *sp, char *elt)
 {
@@ -127,6 +262,13 @@ char * findElement (SET *sp, char *elt)
 	assert((sp != NULL) && (elt != NULL));
 	int locn;
 	bool found;
+	if(sp->packed != NULL)
+		return unpack(sp, elt);
+	/* Build the search tree if it will pay for itself */
+	if(!sp->built && ++sp->finds >= sp->count)
+		build(sp);
+	if(sp->built)
+		return (locn = lookup(sp, elt)) < 0 ? NULL : sp->data[locn];
 	/* Search for element */
 	locn = search(sp, elt, &found);
 	/* Return NULL if not found */
@@ -152,11 +294,196 @@ char ** getElements (SET *sp)
 	assert(DataCopy != NULL);
 	/* Inititialize Pointers to elemens of original array */
 	int i;
+	char *p, *s;
+	if(sp->packed == NULL)
+	{
+		for(i=0; i<sp->count; i++)
+			DataCopy[i] = sp->data[i];
+		return DataCopy;
+	}
+	/* Decode every string of a compressed set into one buffer */
+	free(sp->expanded);
+	sp->expanded = malloc(sp->size);
+	assert(sp->expanded != NULL);
+	p = sp->packed;
+	s = sp->expanded;
 	for(i=0; i<sp->count; i++)
-		DataCopy[i] = sp->data[i];
+	{
+		/* Copy the shared prefix from the string before */
+		if(i % BLOCK != 0)
+			memcpy(s, DataCopy[i-1], (unsigned char) *p);
+		DataCopy[i] = s;
+		p = decode(p, s, i % BLOCK == 0);
+		s += strlen(s) + 1;
+	}
 	return DataCopy;
 }
 
+/*
+ * Function Name: compressSet
+ * Time Complexity: O(n)
+ * Description: Front code the strings in blocks of BLOCK. The first string of a block is
+ * 	stored whole, and each other string as the length of the prefix it shares with the
+ * 	one before it followed by the rest of it. The arena and arrays are freed.
+ */
+void compressSet (SET *sp)
+{
+	assert(sp != NULL);
+	int i, shared, length, longest;
+	size_t used;
+	char *prev, *s;
+	if(sp->packed != NULL)
+		return;
+	/* Find an upper bound on the packed size */
+	sp->size = 0;
+	longest = 0;
+	for(i=0; i<sp->count; i++)
+	{
+		length = strlen(sp->data[i]);
+		sp->size += length + 1;
+		if(length > longest)
+			longest = length;
+	}
+	sp->packed = malloc(sp->size + sp->count + 1);
+	assert(sp->packed != NULL);
+	sp->nblocks = (sp->count + BLOCK - 1) / BLOCK;
+	sp->blocks = malloc(sizeof(int) * (sp->nblocks + 1));
+	assert(sp->blocks != NULL);
+	sp->scratch = malloc(longest + 1);
+	assert(sp->scratch != NULL);
+	/* Pack each string after the one before it */
+	used = 0;
+	prev = NULL;
+	for(i=0; i<sp->count; i++)
+	{
+		s = sp->data[i];
+		if(i % BLOCK == 0)
+			sp->blocks[i / BLOCK] = used;
+		else
+		{
+			/* Shared length must fit in a byte */
+			for(shared=0; shared<255 && s[shared] == prev[shared] && s[shared] != '\0'; shared++)
+				;
+			sp->packed[used++] = shared;
+			s += shared;
+		}
+		length = strlen(s) + 1;
+		memcpy(sp->packed + used, s, length);
+		used += length;
+		prev = sp->data[i];
+	}
+	sp->blocks[sp->nblocks] = used; /* Blocks end where the packed strings do */
+	sp->packed = realloc(sp->packed, used + 1);
+	assert(sp->packed != NULL);
+	/* Strings now live in packed */
+	destroyArena(sp->arena);
+	sp->arena = createArena();
+	free(sp->data);
+	free(sp->prefix);
+	free(sp->tree);
+	free(sp->order);
+	sp->data = NULL;
+	sp->prefix = NULL;
+	sp->tree = NULL;
+	sp->order = NULL;
+}
+
+/*
+ * Function Name: setMemory
+ * Time Complexity: O(n)
+ * Description: Return the bytes used by the strings and the arrays that find them: the
+ * 	pointers and prefixes of each element, or the block offsets once compressed
+ */
+size_t setMemory (SET *sp)
+{
+	assert(sp != NULL);
+	size_t size;
+	int i;
+	if(sp->packed != NULL)
+		return sp->blocks[sp->nblocks] + sizeof(int) * (sp->nblocks + 1);
+	size = (sizeof(char *) + sizeof(unsigned long long)) * sp->count;
+	for(i=0; i<sp->count; i++)
+		size += strlen(sp->data[i]) + 1;
+	return size;
+}
+
+/*
+ * Function Name: findRange
+ * Time Complexity: O(log(n))
+ * Description: Return the part of the array holding the elements from lo to hi, inclusive,
+ * 	and store how many there are in n. Nothing is copied, so the elements are only valid
+ * 	until the set changes. A compressed set is expanded first.
+ */
+char ** findRange (SET *sp, char *lo, char *hi, int *n)
+{
+	assert((sp != NULL) && (lo != NULL) && (hi != NULL) && (n != NULL));
+	int first, last;
+	thaw(sp);
+	first = bound(sp, lo, SIZE_MAX, false);
+	last = bound(sp, hi, SIZE_MAX, true);
+	*n = last > first ? last - first : 0;
+	return sp->data + first;
+}
+
+/*
+ * Function Name: findPrefix
+ * Time Complexity: O(log(n) + length of prefix)
+ * Description: Return the part of the array holding the elements that start with prefix,
+ * 	and store how many there are in n. They are adjacent since the array is sorted.
+ * 	Nothing is copied, as in findRange.
+ */
+char ** findPrefix (SET *sp, char *prefix, int *n)
+{
+	assert((sp != NULL) && (prefix != NULL) && (n != NULL));
+	int first, last;
+	size_t len = strlen(prefix);
+	thaw(sp);
+	first = bound(sp, prefix, len, false);
+	last = bound(sp, prefix, len, true);
+	*n = last - first;
+	return sp->data + first;
+}
+
+/*
+ * Function Name: unionSets
+ * Time Complexity: O(n+m)
+ * Description: Create a new set of the elements in either set
+ */
+SET *unionSets (SET *a, SET *b)
+{
+	return merge(a, b, ONLY_A | BOTH | ONLY_B);
+}
+
+/*
+ * Function Name: intersectSets
+ * Time Complexity: O(n+m), O(m log(n/m)) comparisons if m is much less than n
+ * Description: Create a new set of the elements in both sets
+ */
+SET *intersectSets (SET *a, SET *b)
+{
+	return merge(a, b, BOTH);
+}
+
+/*
+ * Function Name: differenceSets
+ * Time Complexity: O(n+m), O(m log(n/m)) comparisons if m is much less than n
+ * Description: Create a new set of the elements in the first set but not the second
+ */
+SET *differenceSets (SET *a, SET *b)
+{
+	return merge(a, b, ONLY_A);
+}
+
+/*
+ * Function Name: symmetricDifference
+ * Time Complexity: O(n+m)
+ * Description: Create a new set of the elements in exactly one of the sets
+ */
+SET *symmetricDifference (SET *a, SET *b)
+{
+	return merge(a, b, ONLY_A | ONLY_B);
+}
+
 /*
  * Function Name: search
  * Time Complexity: O(log(n))
@@ -166,13 +493,14 @@ static int search (SET *sp, char *elt, bool *found)
 {
 	/* Initialize variables */
 	int lo,hi,mid,diff;
+	unsigned long long key = prefix(elt);
 	lo = 0;
 	hi = sp->count-1;
-	/* Loop for binary search */
+	/* Loop for binary search, only comparing strings when prefixes tie */
 	while(lo <= hi){
 		mid = (lo+hi)/2;
 		/* Compare middle element with elt, then change bounds*/
-		diff = strcmp(elt,sp->data[mid]);
+		diff = key < sp->prefix[mid] ? -1 : key > sp->prefix[mid] ? 1 : strcmp(elt,sp->data[mid]);
 		if(diff < 0)
 			hi = mid - 1;
 		else if (diff > 0)
@@ -187,3 +515,351 @@ static int search (SET *sp, char *elt, bool *found)
 	*found = false;
 	return lo;
 }
+
+/*
+ * Function Name: compare
+ * Time Complexity: O(1)
+ * Description: Utility function; Compare two strings for qsort
+ */
+static int compare (const void *a, const void *b)
+{
+	return strcmp(*(char **) a, *(char **) b);
+}
+
+/*
+ * Function Name: lookup
+ * Time Complexity: O(log(n))
+ * Description: Utility function; Search the Eytzinger tree for an element and return
+ * 	its index in data, or -1 if not found. The children of node k are 2k and 2k+1,
+ * 	so the top of the tree shares a few cache lines and the nodes a few levels down
+ * 	are prefetched while the current level is compared.
+ */
+static int lookup (SET *sp, char *elt)
+{
+	unsigned long long key = prefix(elt);
+	int k = 1;
+	bool less;
+	/* Descend to the first node not less than elt */
+	while(k <= sp->count)
+	{
+		__builtin_prefetch(sp->tree + 8*k);
+		if(sp->tree[k] != key)
+			less = sp->tree[k] < key;
+		else
+			less = strcmp(sp->data[sp->order[k]], elt) < 0;
+		k = 2*k + less;
+	}
+	/* Undo the right turns taken after the last left turn */
+	k >>= __builtin_ffs(~k);
+	if(k == 0 || sp->tree[k] != key || strcmp(sp->data[sp->order[k]], elt) != 0)
+		return -1;
+	return sp->order[k];
+}
+
+/*
+ * Function Name: build
+ * Time Complexity: O(n)
+ * Description: Utility function; Lay out the prefixes in Eytzinger order. The tree is
+ * 	aligned to a cache line so the 8 grandchildren three levels down share one line.
+ */
+static void build (SET *sp)
+{
+	size_t size;
+	if(sp->tree == NULL)
+	{
+		size = (sizeof(unsigned long long) * (sp->length + 1) + 63) & ~(size_t) 63;
+		sp->tree = aligned_alloc(64, size);
+		assert(sp->tree != NULL);
+		sp->order = malloc(sizeof(int) * (sp->length + 1));
+		assert(sp->order != NULL);
+	}
+	layout(sp, 0, 1);
+	sp->built = true;
+}
+
+/*
+ * Function Name: layout
+ * Time Complexity: O(n)
+ * Description: Utility function; Fill the subtree at node k with the sorted elements
+ * 	starting at index i by an in-order walk, return the index after the last one used
+ */
+static int layout (SET *sp, int i, int k)
+{
+	if(k <= sp->count)
+	{
+		i = layout(sp, i, 2*k);
+		sp->tree[k] = sp->prefix[i];
+		sp->order[k] = i++;
+		i = layout(sp, i, 2*k+1);
+	}
+	return i;
+}
+
+/*
+ * Function Name: prefix
+ * Time Complexity: O(1)
+ * Description: Utility function; Pack the first 8 bytes of a string into a big-endian
+ * 	integer, padded with zeros, so integers compare in the same order as strcmp
+ */
+static unsigned long long prefix (char *s)
+{
+	unsigned long long key = 0;
+	int i;
+	for(i=0; i<8; i++)
+	{
+		key <<= 8;
+		if(*s != '\0')
+			key |= (unsigned char) *s++;
+	}
+	return key;
+}
+
+/*
+ * Function Name: changed
+ * Time Complexity: O(1)
+ * Description: Utility function; Mark the search tree out of date after a change
+ */
+static void changed (SET *sp)
+{
+	sp->finds = 0;
+	sp->built = false;
+}
+
+/*
+ * Function Name: unpack
+ * Time Complexity: O(log(n))
+ * Description: Utility function; Find an element in a compressed set. Binary search the
+ * 	whole strings at the head of each block, then decode the one block that may hold it.
+ * 	Return the decoded copy in scratch if found, else return NULL.
+ */
+static char *unpack (SET *sp, char *elt)
+{
+	int lo,hi,mid,diff,i;
+	char *p;
+	lo = 0;
+	hi = sp->nblocks-1;
+	/* Find the last block whose head is not greater than elt */
+	while(lo <= hi){
+		mid = (lo+hi)/2;
+		diff = strcmp(elt, sp->packed + sp->blocks[mid]);
+		if(diff < 0)
+			hi = mid - 1;
+		else if (diff > 0)
+			lo = mid + 1;
+		else
+			return strcpy(sp->scratch, elt);
+	}
+	if(hi < 0)
+		return NULL;
+	/* Decode the block in order until elt is reached or passed */
+	p = decode(sp->packed + sp->blocks[hi], sp->scratch, true);
+	for(i=hi*BLOCK+1; i<sp->count && i<(hi+1)*BLOCK; i++)
+	{
+		p = decode(p, sp->scratch, false);
+		diff = strcmp(sp->scratch, elt);
+		if(diff == 0)
+			return sp->scratch;
+		if(diff > 0)
+			break;
+	}
+	return NULL;
+}
+
+/*
+ * Function Name: decode
+ * Time Complexity: O(1)
+ * Description: Utility function; Decode the front coded string at p over the string before
+ * 	it in s, or whole if it is the head of a block, and return where the next one starts
+ */
+static char *decode (char *p, char *s, bool head)
+{
+	int shared = head ? 0 : (unsigned char) *p++;
+	strcpy(s + shared, p);
+	return p + strlen(p) + 1;
+}
+
+/*
+ * Function Name: thaw
+ * Time Complexity: O(n)
+ * Description: Utility function; Turn a compressed set back into separate strings so it
+ * 	can be changed
+ */
+static void thaw (SET *sp)
+{
+	int i;
+	char *p;
+	if(sp->packed == NULL)
+		return;
+	sp->data = malloc(sizeof(char *) * sp->length);
+	assert(sp->data != NULL);
+	sp->prefix = malloc(sizeof(unsigned long long) * sp->length);
+	assert(sp->prefix != NULL);
+	/* Decode each string and copy it out */
+	p = sp->packed;
+	for(i=0; i<sp->count; i++)
+	{
+		p = decode(p, sp->scratch, i % BLOCK == 0);
+		sp->data[i] = copyString(sp->arena, sp->scratch);
+		sp->prefix[i] = prefix(sp->data[i]);
+	}
+	free(sp->packed);
+	free(sp->blocks);
+	free(sp->scratch);
+	free(sp->expanded);
+	sp->packed = NULL;
+	sp->expanded = NULL;
+	changed(sp);
+}
+
+/*
+ * Function Name: merge
+ * Time Complexity: O(n+m)
+ * Description: Utility function; Walk both sets in order, like the merge step of merge sort,
+ * 	and copy into a new set the elements whose kind is in keep: only in a, in both, or
+ * 	only in b. If one set is much larger, runs of it are skipped by galloping instead of
+ * 	being compared one at a time. Compressed sets are expanded first.
+ */
+static SET *merge (SET *a, SET *b, int keep)
+{
+	assert((a != NULL) && (b != NULL));
+	SET *sp;
+	int i, j, k, length, diff;
+	bool galloping;
+	thaw(a);
+	thaw(b);
+	/* New set is as long as the larger set, or long enough for both */
+	length = a->length > b->length ? a->length : b->length;
+	if(length < a->count + b->count)
+		length = a->count + b->count;
+	sp = createSet(length);
+	galloping = a->count > GALLOP * b->count || b->count > GALLOP * a->count;
+	i = 0;
+	j = 0;
+	while(i < a->count && j < b->count)
+	{
+		/* Compare prefixes first, strings only on a tie */
+		if(a->prefix[i] != b->prefix[j])
+			diff = a->prefix[i] < b->prefix[j] ? -1 : 1;
+		else
+			diff = strcmp(a->data[i], b->data[j]);
+		if(diff < 0)
+		{
+			/* Skip the run of a before b[j] */
+			k = galloping ? gallop(a, i, b->data[j]) : i + 1;
+			if(keep & ONLY_A)
+				append(sp, a, i, k);
+			i = k;
+		}
+		else if(diff > 0)
+		{
+			/* Skip the run of b before a[i] */
+			k = galloping ? gallop(b, j, a->data[i]) : j + 1;
+			if(keep & ONLY_B)
+				append(sp, b, j, k);
+			j = k;
+		}
+		else
+		{
+			if(keep & BOTH)
+				append(sp, a, i, i + 1);
+			i++;
+			j++;
+		}
+	}
+	/* Copy whichever set has elements left */
+	if(keep & ONLY_A)
+		append(sp, a, i, a->count);
+	if(keep & ONLY_B)
+		append(sp, b, j, b->count);
+	return sp;
+}
+
+/*
+ * Function Name: gallop
+ * Time Complexity: O(log(k)) where k is the distance moved
+ * Description: Utility function; Return the index of the first element after lo that is not
+ * 	less than elt, given that the one at lo is less. Steps of 1, 2, 4, ... bound the index,
+ * 	then binary search finds it.
+ */
+static int gallop (SET *sp, int lo, char *elt)
+{
+	int hi, mid, step;
+	/* Double the step until an element is not less than elt */
+	step = 1;
+	hi = lo + 1;
+	while(hi < sp->count && strcmp(sp->data[hi], elt) < 0)
+	{
+		lo = hi;
+		step *= 2;
+		hi = lo + step;
+	}
+	if(hi > sp->count)
+		hi = sp->count;
+	/* Binary search between the last two steps */
+	lo++;
+	while(lo < hi)
+	{
+		mid = (lo+hi)/2;
+		if(strcmp(sp->data[mid], elt) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * Function Name: append
+ * Time Complexity: O(k) where k is hi-lo
+ * Description: Utility function; Copy the elements of src from lo up to hi onto the end of
+ * 	dst. They must all be greater than the elements already in dst.
+ */
+static void append (SET *dst, SET *src, int lo, int hi)
+{
+	assert(dst->count + hi - lo <= dst->length);
+	for(; lo<hi; lo++)
+	{
+		dst->data[dst->count] = copyString(dst->arena, src->data[lo]);
+		dst->prefix[dst->count++] = src->prefix[lo];
+	}
+}
+
+/*
+ * Function Name: bound
+ * Time Complexity: O(log(n))
+ * Description: Utility function; Use binary search on the first len characters of each
+ * 	element to return the index of the first one not less than elt, or if after is true
+ * 	the index of the first one greater than elt
+ */
+static int bound (SET *sp, char *elt, size_t len, bool after)
+{
+	int lo,hi,mid,diff;
+	lo = 0;
+	hi = sp->count;
+	while(lo < hi)
+	{
+		mid = (lo+hi)/2;
+		diff = strncmp(sp->data[mid], elt, len);
+		if(diff < 0 || (after && diff == 0))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * Function Name: compact
+ * Time Complexity: O(n)
+ * Description: Utility function; Copy the strings into a new arena in sorted order and
+ * 	free the old one, along with the space of every string released from it
+ */
+static void compact (SET *sp)
+{
+	ARENA *arena = createArena();
+	int i;
+	for(i=0; i<sp->count; i++)
+		sp->data[i] = copyString(arena, sp->data[i]);
+	destroyArena(sp->arena);
+	sp->arena = arena;
+}
@@ -0,0 +1,44 @@
+/*
+ * File:        sorted.h
+ *
+ * Description: This file contains the declarations of the functions that
+ *              only the sorted array implementation of a set provides, on
+ *              top of those in set.h.
+ *
+ *              A compressed set keeps its strings front coded, so
+ *              findElement returns a copy owned by the set that is only
+ *              valid until the next call, and the strings returned by
+ *              getElements are only valid until the next getElements or
+ *              change to the set.  Changing a compressed set expands it.
+ *
+ *              The range and prefix queries return a part of the set's
+ *              own array, which is only valid until the set changes.
+ *
+ *              The set operations each return a new set and leave the
+ *              two sets given unchanged, other than expanding them if
+ *              they are compressed.
+ */
+
+# ifndef SORTED_H
+# define SORTED_H
+
+# include <stddef.h>
+# include "set.h"
+
+void compressSet(SET *sp);
+
+size_t setMemory(SET *sp);
+
+char **findRange(SET *sp, char *lo, char *hi, int *n);
+
+char **findPrefix(SET *sp, char *prefix, int *n);
+
+SET *unionSets(SET *a, SET *b);
+
+SET *intersectSets(SET *a, SET *b);
+
+SET *differenceSets(SET *a, SET *b);
+
+SET *symmetricDifference(SET *a, SET *b);
+
+# endif /* SORTED_H */
@@ -3,17 +3,27 @@
 #include <string.h>
 #include <assert.h>
 #include "set.h"
+#include "arena.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 struct set 
 {
 	int count; /* number of elements */
 	int length; /* length of array */
 	char ** data; /* array strings */
+	unsigned *print; /* fingerprint of each string, kept in step with data */
+	int *size; /* length of each string */
+	ARENA *arena; /* storage for the strings */
 };
 
 typedef struct set SET;
 
 static int search (SET *sp, char *elt);
+static unsigned fingerprint (char *s, int *len);
+static void compact (SET *sp);
 
 /* 
  * Function Name: createSet
@@ -32,6 +42,11 @@ SET *createSet (int maxElts)
 	/* Allocate data, assert data has memory */
 	sp ->data = malloc(sizeof(char *) * maxElts);
 	assert(sp ->data != NULL);
+	sp ->print = malloc(sizeof(unsigned) * maxElts);
+	assert(sp ->print != NULL);
+	sp ->size = malloc(sizeof(int) * maxElts);
+	assert(sp ->size != NULL);
+	sp ->arena = createArena();
 	return sp;
 }
 
@@ -42,12 +57,12 @@ SET *createSet (int maxElts)
  */
 void destroySet (SET *sp)
 {
-	int i;
 	/* Free data */
-	for(i=0; i<sp->count; i++)
-		free(sp->data[i]);
-	/* Free array */
+	destroyArena(sp->arena);
+	/* Free arrays */
 	free(sp->data);
+	free(sp->print);
+	free(sp->size);
 	/* Free set */
 	free(sp);
 }
@@ -79,17 +94,32 @@ void addElement (SET *sp, char *elt)
 	/* Add if not found*/
 	if(posn == -1)
 	{
-		/* Make sure element has memory, add element, increment counter */
-		NewElt = strdup(elt);
-		assert(NewElt != NULL);
+		/* Copy element into the arena, add element, increment counter */
+		NewElt = copyString(sp->arena, elt);
+		sp->print[sp->count] = fingerprint(NewElt, &sp->size[sp->count]);
 		sp->data[sp->count++] = NewElt;
 	}
 }
 
+/*
+ * Function Name: addElements
+ * Time Complexity: O(mn)
+ * Description: Add a batch of elements to the set, one at a time
+ */
+void addElements (SET *sp, char **elts, int n)
+{
+	assert((sp != NULL) && ((elts != NULL) || (n == 0)));
+	int i;
+	for(i=0; i<n; i++)
+		addElement(sp, elts[i]);
+}
+
 /*
  * Function Name: removeElement
  * Time Complexity: O(n)
- * Description: Remove an Element in the set
+ * Description: Remove an Element in the set. Once most of the arena is released strings,
+ * 	the rest are compacted into a new one, so pointers to elements are only valid until
+ * 	the next removal.
  */
 void removeElement (SET *sp, char *elt)
 {
@@ -100,9 +130,13 @@ void removeElement (SET *sp, char *elt)
 	locn = search(sp,elt);
 	/* Remove if found */
 	if(locn != -1) {
-		/* Free element, move last element to empty space, decrement counter */
-		free(sp->data[locn]);
+		/* Release element, move last element to empty space, decrement counter */
+		releaseString(sp->arena, sp->data[locn]);
 		sp -> data [locn] = sp->data[--sp->count];
+		sp -> print [locn] = sp->print[sp->count];
+		sp -> size [locn] = sp->size[sp->count];
+		if(needsCompaction(sp->arena))
+			compact(sp);
 	}
 }
 
@@ -148,18 +182,77 @@ char ** getElements (SET *sp)
 /*
  * Function Name: search
  * Time Complexity: O(n)
- * Description: Utility function; Use sequential search to return location of element, return -1 if element is not there
+ * Description: Utility function; Use sequential search to return location of element, return -1 if element is not there.
+ * 	The fingerprints and lengths are compared four at a time, and a string is only compared on a match.
  */
 static int search (SET *sp, char *elt)
 {
-	int i;
-	/* Traverse data to look for elt */
-	for(i=0;i<sp->count;i++)
+	int i, j, len;
+	unsigned print = fingerprint(elt, &len);
+	i = 0;
+#ifdef __SSE2__
+	__m128i key, size, hits;
+	int mask;
+	key = _mm_set1_epi32(print);
+	size = _mm_set1_epi32(len);
+	/* Traverse fingerprints in blocks of four */
+	for(; i+4 <= sp->count; i+=4)
+	{
+		hits = _mm_and_si128(
+			_mm_cmpeq_epi32(_mm_loadu_si128((__m128i *) (sp->print + i)), key),
+			_mm_cmpeq_epi32(_mm_loadu_si128((__m128i *) (sp->size + i)), size));
+		mask = _mm_movemask_ps(_mm_castsi128_ps(hits));
+		/* Return location if a match is really elt */
+		while(mask != 0)
+		{
+			j = i + __builtin_ctz(mask);
+			if(memcmp(sp->data[j], elt, len) == 0)
+				return j;
+			mask &= mask - 1;
+		}
+	}
+#endif
+	/* Traverse the rest one at a time */
+	for(j=i;j<sp->count;j++)
 	{
 		/* Return location if found */
-		if(strcmp(sp->data[i], elt) == 0)
-			return i;
+		if(sp->print[j] == print && sp->size[j] == len && memcmp(sp->data[j], elt, len) == 0)
+			return j;
 	}
 	/* Return -1 if not found */
 	return -1;
 }
+
+/*
+ * Function Name: fingerprint
+ * Time Complexity: O(n)
+ * Description: Utility function; Return an FNV-1a hash of a string and store its length in len
+ */
+static unsigned fingerprint (char *s, int *len)
+{
+	unsigned hash = 2166136261u;
+	char *p;
+	for(p=s; *p != '\0'; p++)
+	{
+		hash ^= (unsigned char) *p;
+		hash *= 16777619u;
+	}
+	*len = p - s;
+	return hash;
+}
+
+/*
+ * Function Name: compact
+ * Time Complexity: O(n)
+ * Description: Utility function; Copy the strings into a new arena in the order of the array
+ * 	and free the old one, along with the space of every string released from it
+ */
+static void compact (SET *sp)
+{
+	ARENA *arena = createArena();
+	int i;
+	for(i=0; i<sp->count; i++)
+		sp->data[i] = copyString(arena, sp->data[i]);
+	destroyArena(sp->arena);
+	sp->arena = arena;
+}
@@ -0,0 +1,389 @@
+/*
+ * File:        cache.c
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for a cache of per-file results kept on disk.
+ *
+ *              Each entry records what kind of result it is, the file's
+ *              path, size, and modification time, the total and distinct
+ *              word counts, and optionally a string of extra data.  The
+ *              cache file holds one tab-separated entry per line with the
+ *              path last.  It is read when the cache is created and
+ *              rewritten, through a temporary file, when it is destroyed.
+ *
+ *              Entries are kept in a hash table with chaining, and a lock
+ *              allows several threads to use the cache at once.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <assert.h>
+# include <stdbool.h>
+# include <pthread.h>
+# include <sys/stat.h>
+# include "cache.h"
+
+# define MIN_LENGTH 64
+
+struct entry {
+    char *kind;			/* kind of result                  */
+    char *file;			/* path of the file                */
+    long long size;		/* size of the file in bytes       */
+    long long sec;		/* modification time, seconds      */
+    long nsec;			/* modification time, nanoseconds  */
+    long words;			/* total words                     */
+    long distinct;		/* distinct words                  */
+    char *data;			/* extra data, or NULL             */
+    struct entry *next;		/* next entry in the same chain    */
+};
+
+struct cache {
+    char *path;			/* path of the cache file          */
+    int count;			/* number of entries               */
+    int length;			/* number of chains                */
+    struct entry **heads;	/* array of chains                 */
+    bool changed;		/* true if entries were added      */
+    pthread_mutex_t lock;	/* protects all of the above       */
+};
+
+
+/*
+ * Function:    keyhash
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return a hash value for the pair of strings KIND and FILE.
+ */
+
+static unsigned keyhash(char *kind, char *file)
+{
+    unsigned hash = 0;
+
+
+    while (*kind != '\0')
+	hash = 31 * hash + *kind ++;
+
+    while (*file != '\0')
+	hash = 31 * hash + *file ++;
+
+    return hash;
+}
+
+
+/*
+ * Function:    search
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Return the entry for KIND and FILE in the cache pointed to
+ *		by CP, or NULL if there is none.
+ */
+
+static struct entry *search(CACHE *cp, char *kind, char *file)
+{
+    struct entry *ep;
+
+
+    ep = cp->heads[keyhash(kind, file) % cp->length];
+
+    while (ep != NULL) {
+	if (strcmp(ep->file, file) == 0 && strcmp(ep->kind, kind) == 0)
+	    return ep;
+
+	ep = ep->next;
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function:    insert
+ *
+ * Complexity:  O(1) average case, O(n) when the table grows
+ *
+ * Description: Add the entry pointed to by EP to the cache pointed to by
+ *		CP.  The table is doubled when it averages two entries per
+ *		chain.
+ */
+
+static void insert(CACHE *cp, struct entry *ep)
+{
+    struct entry **heads, *np, *next;
+    int i, locn, length;
+
+
+    if (cp->count >= 2 * cp->length) {
+	length = cp->length * 2;
+	heads = calloc(length, sizeof(struct entry *));
+	assert(heads != NULL);
+
+	for (i = 0; i < cp->length; i ++)
+	    for (np = cp->heads[i]; np != NULL; np = next) {
+		next = np->next;
+		locn = keyhash(np->kind, np->file) % length;
+		np->next = heads[locn];
+		heads[locn] = np;
+	    }
+
+	free(cp->heads);
+	cp->heads = heads;
+	cp->length = length;
+    }
+
+    locn = keyhash(ep->kind, ep->file) % cp->length;
+    ep->next = cp->heads[locn];
+    cp->heads[locn] = ep;
+    cp->count ++;
+}
+
+
+/*
+ * Function:    createCache
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return a pointer to a new cache holding the entries in the
+ *		file named PATH.  A missing or unreadable file gives an
+ *		empty cache, and lines that cannot be parsed are ignored.
+ */
+
+CACHE *createCache(char *path)
+{
+    CACHE *cp;
+    FILE *fp;
+    struct entry e, *ep;
+    char *line, *fields[8], *s;
+    size_t size;
+    int n;
+
+
+    assert(path != NULL);
+
+    cp = malloc(sizeof(CACHE));
+    assert(cp != NULL);
+
+    cp->path = strdup(path);
+    assert(cp->path != NULL);
+
+    cp->count = 0;
+    cp->length = MIN_LENGTH;
+    cp->heads = calloc(cp->length, sizeof(struct entry *));
+    assert(cp->heads != NULL);
+
+    cp->changed = false;
+    pthread_mutex_init(&cp->lock, NULL);
+
+    if ((fp = fopen(path, "r")) == NULL)
+	return cp;
+
+    line = NULL;
+    size = 0;
+
+    while (getline(&line, &size, fp) != -1) {
+	line[strcspn(line, "\n")] = '\0';
+
+
+	/* Split the line into its eight fields; the path may hold tabs. */
+
+	s = line;
+
+	for (n = 0; n < 7 && (fields[n] = strsep(&s, "\t")) != NULL; n ++)
+	    ;
+
+	if (n < 7 || s == NULL || *s == '\0')
+	    continue;
+
+	fields[7] = s;
+
+	e.size = atoll(fields[1]);
+	e.sec = atoll(fields[2]);
+	e.nsec = atol(fields[3]);
+	e.words = atol(fields[4]);
+	e.distinct = atol(fields[5]);
+
+	ep = malloc(sizeof(struct entry));
+	assert(ep != NULL);
+
+	*ep = e;
+	ep->kind = strdup(fields[0]);
+	ep->data = strcmp(fields[6], "-") != 0 ? strdup(fields[6]) : NULL;
+	ep->file = strdup(fields[7]);
+	assert(ep->kind != NULL && ep->file != NULL);
+
+	insert(cp, ep);
+    }
+
+    free(line);
+    fclose(fp);
+    return cp;
+}
+
+
+/*
+ * Function:    destroyCache
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Write the cache pointed to by CP back to its file if any
+ *		entries were added, then deallocate it.  The new contents
+ *		are written to a temporary file and renamed over the old
+ *		file, so an interrupted run never leaves a partial cache.
+ */
+
+void destroyCache(CACHE *cp)
+{
+    FILE *fp;
+    struct entry *ep, *next;
+    char *temp;
+    int i;
+
+
+    assert(cp != NULL);
+
+    fp = NULL;
+    temp = NULL;
+
+    if (cp->changed) {
+	temp = malloc(strlen(cp->path) + 5);
+	assert(temp != NULL);
+
+	sprintf(temp, "%s.tmp", cp->path);
+
+	if ((fp = fopen(temp, "w")) == NULL)
+	    fprintf(stderr, "cannot write cache %s\n", temp);
+    }
+
+    for (i = 0; i < cp->length; i ++)
+	for (ep = cp->heads[i]; ep != NULL; ep = next) {
+	    next = ep->next;
+
+	    if (fp != NULL)
+		fprintf(fp, "%s\t%lld\t%lld\t%ld\t%ld\t%ld\t%s\t%s\n", ep->kind,
+		    ep->size, ep->sec, ep->nsec, ep->words, ep->distinct,
+		    ep->data != NULL ? ep->data : "-", ep->file);
+
+	    free(ep->kind);
+	    free(ep->file);
+	    free(ep->data);
+	    free(ep);
+	}
+
+    if (fp != NULL && (fclose(fp) != 0 || rename(temp, cp->path) != 0))
+	fprintf(stderr, "cannot write cache %s\n", cp->path);
+
+    pthread_mutex_destroy(&cp->lock);
+
+    free(temp);
+    free(cp->heads);
+    free(cp->path);
+    free(cp);
+}
+
+
+/*
+ * Function:    unchanged
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return true if the statuses pointed to by A and B give the
+ *		same size and modification time.
+ */
+
+static bool unchanged(struct stat *a, struct stat *b)
+{
+    return a->st_size == b->st_size && a->st_mtim.tv_sec == b->st_mtim.tv_sec
+	&& a->st_mtim.tv_nsec == b->st_mtim.tv_nsec;
+}
+
+
+/*
+ * Function:    findEntry
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Look up the result of kind KIND for the file named FILE,
+ *		whose status is pointed to by ST, in the cache pointed to by
+ *		CP.  If the file has not changed then store the counts in
+ *		*WORDS and *DISTINCT, store a copy of the extra data (or
+ *		NULL) in *DATA if DATA is not NULL, and return true.
+ */
+
+bool findEntry(CACHE *cp, char *kind, char *file, struct stat *st, long *words, long *distinct, char **data)
+{
+    struct entry *ep;
+    bool found;
+
+
+    assert(cp != NULL && kind != NULL && file != NULL && st != NULL);
+
+    pthread_mutex_lock(&cp->lock);
+
+    ep = search(cp, kind, file);
+    found = ep != NULL && ep->size == st->st_size &&
+	ep->sec == st->st_mtim.tv_sec && ep->nsec == st->st_mtim.tv_nsec;
+
+    if (found) {
+	*words = ep->words;
+	*distinct = ep->distinct;
+
+	if (data != NULL)
+	    *data = ep->data != NULL ? strdup(ep->data) : NULL;
+    }
+
+    pthread_mutex_unlock(&cp->lock);
+    return found;
+}
+
+
+/*
+ * Function:    addEntry
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Record the result of kind KIND for the file named FILE in
+ *		the cache pointed to by CP, replacing any older result.  ST
+ *		points to the status of the file taken before it was read;
+ *		if the file has changed since then the result is dropped,
+ *		since it may not match either version.  DATA is copied and
+ *		may be NULL; it must not contain tabs or newlines.
+ */
+
+void addEntry(CACHE *cp, char *kind, char *file, struct stat *st, long words, long distinct, char *data)
+{
+    struct stat now;
+    struct entry *ep;
+
+
+    assert(cp != NULL && kind != NULL && file != NULL && st != NULL);
+
+    if (stat(file, &now) < 0 || !unchanged(st, &now))
+	return;
+
+    pthread_mutex_lock(&cp->lock);
+
+    if ((ep = search(cp, kind, file)) == NULL) {
+	ep = malloc(sizeof(struct entry));
+	assert(ep != NULL);
+
+	ep->kind = strdup(kind);
+	ep->file = strdup(file);
+	assert(ep->kind != NULL && ep->file != NULL);
+
+	ep->data = NULL;
+	insert(cp, ep);
+    }
+
+    ep->size = st->st_size;
+    ep->sec = st->st_mtim.tv_sec;
+    ep->nsec = st->st_mtim.tv_nsec;
+    ep->words = words;
+    ep->distinct = distinct;
+
+    free(ep->data);
+    ep->data = data != NULL ? strdup(data) : NULL;
+
+    cp->changed = true;
+    pthread_mutex_unlock(&cp->lock);
+}
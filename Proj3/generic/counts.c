@@ -15,6 +15,8 @@
 # include <string.h>
 # include <assert.h>
 # include "set.h"
+# include "reader.h"
+# include "hash.h"
 
 struct entry {
     char *word;
@@ -27,24 +29,6 @@ struct entry {
 # define MAX_SIZE 18000
 
 
-/*
- * Function:    strhash
- *
- * Description: Return a hash value for a string S.
- */
-
-static unsigned strhash(char *s)
-{
-    unsigned hash = 0;
-
-
-    while (*s != '\0')
-        hash = 31 * hash + *s ++;
-
-    return hash;
-}
-
-
 /*
  * Function:	hashEntry
  *
@@ -78,7 +62,8 @@ static int compareEntries(struct entry *ep1, struct entry *ep2)
 int main(int argc, char *argv[])
 {
     FILE *fp;
-    char buffer[BUFSIZ];
+    READER *rp;
+    char *buffer;
     struct entry e, *ep, **entries;
     SET *counts;
     int i;
@@ -100,8 +85,9 @@ int main(int argc, char *argv[])
     /* Increment the count on each word read. */
 
     counts = createSet(MAX_SIZE, compareEntries, hashEntry);
+    rp = createReader(fp);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
+    while ((buffer = readWord(rp, NULL)) != NULL) {
 	e.word = buffer;
 	ep = findElement(counts, &e);
 
@@ -119,6 +105,9 @@ int main(int argc, char *argv[])
 	    ep->count ++;
     }
 
+    destroyReader(rp);
+    fclose(fp);
+
 
     /* Print out the counts for each word. */
 
@@ -0,0 +1,33 @@
+/*
+ * File:        hll.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for a HyperLogLog sketch of strings.  A sketch
+ *              estimates how many distinct strings have been added to it
+ *              using a small fixed amount of memory.
+ */
+
+# ifndef HLL_H
+# define HLL_H
+
+# include <stdbool.h>
+
+# define HLL_LENGTH 4096	/* characters in a sketch written as text */
+
+typedef struct hll HLL;
+
+HLL *createHLL(void);
+
+void destroyHLL(HLL *hp);
+
+void addHLL(HLL *hp, char *elt);
+
+double estimateHLL(HLL *hp);
+
+void mergeHLL(HLL *dst, HLL *src);
+
+void writeHLL(HLL *hp, char *s);
+
+bool readHLL(HLL *hp, char *s);
+
+# endif /* HLL_H */
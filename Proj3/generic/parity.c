@@ -16,6 +16,8 @@
 # include <stdlib.h>
 # include <string.h>
 # include "set.h"
+# include "reader.h"
+# include "hash.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
@@ -23,24 +25,6 @@
 # define MAX_SIZE 18000
 
 
-/*
- * Function:    strhash
- *
- * Description: Return a hash value for a string S.
- */
-
-static unsigned strhash(char *s)
-{
-    unsigned hash = 0;
-
-
-    while (*s != '\0')
-        hash = 31 * hash + *s ++;
-
-    return hash;
-}
-
-
 /*
  * Function:    main
  *
@@ -50,7 +34,8 @@ static unsigned strhash(char *s)
 int main(int argc, char *argv[])
 {
     FILE *fp;
-    char buffer[BUFSIZ], *word;
+    READER *rp;
+    char *buffer, *word;
     SET *odd;
     int words;
 
@@ -72,8 +57,9 @@ int main(int argc, char *argv[])
 
     words = 0;
     odd = createSet(MAX_SIZE, strcmp, strhash);
+    rp = createReader(fp);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
+    while ((buffer = readWord(rp, NULL)) != NULL) {
         words ++;
 
         if ((word = findElement(odd, buffer)) != NULL) {
@@ -85,6 +71,7 @@ int main(int argc, char *argv[])
 
     printf("%d total words\n", words);
     printf("%d words occur an odd number of times\n", numElements(odd));
+    destroyReader(rp);
     fclose(fp);
 
     destroySet(odd);
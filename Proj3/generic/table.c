@@ -135,10 +135,11 @@ void *getElements(SET *sp)
 	assert(sp != NULL);
 	void **dataCopy;
 	dataCopy = malloc(sizeof(void *)*sp->length);
-	int i;
-	for(i=0;i<sp->length;i++){
+	assert(dataCopy != NULL);
+	int i, j;
+	for(i=0, j=0;i<sp->length;i++){ /* Pack filled slots to the front */
 		if(sp->flag[i] == 'F') {
-			dataCopy[i] = sp->data[i];
+			dataCopy[j++] = sp->data[i];
 		}
 	}
 	return dataCopy;
@@ -0,0 +1,176 @@
+/*
+ * File:        arena.c
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for an arena of strings.
+ *
+ *              A string is copied to the end of the current chunk, so
+ *              adding one is usually just a pointer bump, with no header
+ *              per string as malloc would add.  A string too long to be
+ *              worth starting a new chunk for is given a chunk of its own.
+ *              Strings cannot be freed one at a time.  Instead the arena
+ *              keeps count of the bytes released, and once most of it is
+ *              released the owner should compact it by copying the strings
+ *              still in use into a new arena and destroying the old one.
+ */
+
+# include <stdlib.h>
+# include <string.h>
+# include <assert.h>
+# include <stdbool.h>
+# include "arena.h"
+
+# define CHUNK_SIZE 65536	/* usual size of a chunk           */
+# define MAX_COPY (CHUNK_SIZE / 8) /* longest string put in a chunk  */
+
+struct chunk {
+    struct chunk *next;		/* chunk allocated before this one */
+    char data[];		/* strings                         */
+};
+
+struct arena {
+    struct chunk *head;		/* current chunk, or NULL          */
+    char *next;			/* next free byte in current chunk */
+    char *end;			/* end of current chunk            */
+    size_t used;		/* bytes copied in                 */
+    size_t released;		/* bytes of strings released       */
+};
+
+
+/*
+ * Function:    createArena
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return a pointer to a new arena.  No chunk is allocated
+ *		until the first string is copied in.
+ */
+
+ARENA *createArena(void)
+{
+    ARENA *ap;
+
+
+    ap = malloc(sizeof(ARENA));
+    assert(ap != NULL);
+
+    ap->head = NULL;
+    ap->next = ap->end = NULL;
+    ap->used = ap->released = 0;
+    return ap;
+}
+
+
+/*
+ * Function:    destroyArena
+ *
+ * Complexity:  O(c), where c is the number of chunks
+ *
+ * Description: Deallocate the arena pointed to by AP and every string in
+ *		it.
+ */
+
+void destroyArena(ARENA *ap)
+{
+    struct chunk *cp;
+
+
+    assert(ap != NULL);
+
+    while ((cp = ap->head) != NULL) {
+	ap->head = cp->next;
+	free(cp);
+    }
+
+    free(ap);
+}
+
+
+/*
+ * Function:    copyString
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return a copy of the string S in the arena pointed to by
+ *		AP.  A string that does not fit in the rest of the current
+ *		chunk starts a new one, unless it is long, in which case it
+ *		gets a chunk of its own behind the current one so that the
+ *		space left in the current one is not lost.
+ */
+
+char *copyString(ARENA *ap, char *s)
+{
+    size_t length;
+    struct chunk *cp;
+    char *copy;
+
+
+    assert(ap != NULL && s != NULL);
+    length = strlen(s) + 1;
+
+    if (ap->next == NULL || length > (size_t) (ap->end - ap->next)) {
+	if (length > MAX_COPY) {
+	    cp = malloc(sizeof(struct chunk) + length);
+	    assert(cp != NULL);
+
+	    if (ap->head != NULL) {
+		cp->next = ap->head->next;
+		ap->head->next = cp;
+	    } else {
+		cp->next = NULL;
+		ap->head = cp;
+	    }
+
+	    ap->used += length;
+	    return memcpy(cp->data, s, length);
+	}
+
+	cp = malloc(sizeof(struct chunk) + CHUNK_SIZE);
+	assert(cp != NULL);
+
+	cp->next = ap->head;
+	ap->head = cp;
+	ap->next = cp->data;
+	ap->end = cp->data + CHUNK_SIZE;
+    }
+
+    copy = memcpy(ap->next, s, length);
+    ap->next += length;
+    ap->used += length;
+    return copy;
+}
+
+
+/*
+ * Function:    releaseString
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Note that the string S in the arena pointed to by AP is
+ *		no longer in use.  Its space is only reclaimed when the
+ *		arena is compacted.
+ */
+
+void releaseString(ARENA *ap, char *s)
+{
+    assert(ap != NULL && s != NULL);
+    ap->released += strlen(s) + 1;
+}
+
+
+/*
+ * Function:    needsCompaction
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return whether more than half of the bytes copied into the
+ *		arena pointed to by AP have been released, and at least a
+ *		chunk's worth, so that copying out the strings still in use
+ *		is paid for by the releases since the last compaction.
+ */
+
+bool needsCompaction(ARENA *ap)
+{
+    assert(ap != NULL);
+    return ap->released >= CHUNK_SIZE && ap->released > ap->used / 2;
+}
@@ -0,0 +1,94 @@
+/*
+ * File:        counts.c
+ *
+ * Description: This file contains the main function for testing the
+ *              interning of strings in a set.
+ *
+ *              The program takes one file as a command line argument and
+ *              counts the number of times each word appears in the file.
+ *              Each word is interned once, and its id indexes an array of
+ *              counts, so no entry is allocated or looked up per word.
+ *              The words are printed in the order they first appear.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <assert.h>
+# include "set.h"
+# include "intern.h"
+# include "reader.h"
+
+
+/* This is sufficient for the test cases in /scratch/coen12. */
+
+# define MAX_SIZE 18000
+
+
+/*
+ * Function:    main
+ *
+ * Description: Driver function for the test application.
+ */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    READER *rp;
+    char *buffer;
+    SET *words;
+    int *counts;
+    unsigned id, j, length;
+    int i;
+
+
+    /* Check usage and open the file. */
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s file\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp = fopen(argv[1], "r")) == NULL) {
+        fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+        exit(EXIT_FAILURE);
+    }
+
+
+    /* Increment the count of each word read by its id. */
+
+    words = createSet(MAX_SIZE);
+    length = MAX_SIZE;
+    counts = calloc(length, sizeof(int));
+    assert(counts != NULL);
+    rp = createReader(fp);
+
+    while ((buffer = readWord(rp, NULL)) != NULL) {
+	id = intern(words, buffer);
+
+	if (id >= length) {
+	    counts = realloc(counts, sizeof(int) * length * 2);
+	    assert(counts != NULL);
+
+	    for (j = length; j < length * 2; j ++)
+		counts[j] = 0;
+
+	    length *= 2;
+	}
+
+	counts[id] ++;
+    }
+
+    destroyReader(rp);
+    fclose(fp);
+
+
+    /* Print out the counts for each word.  Nothing was removed, so the
+       ids are exactly the numbers below the number of elements. */
+
+    for (i = 0; i < numElements(words); i ++)
+	printf("%s: %d\n", lookupId(words, i), counts[i]);
+
+    free(counts);
+    destroySet(words);
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,18 @@
+/*
+ * File:        hash.h
+ *
+ * Description: This file contains the public function declarations for
+ *              hashing strings.  The hash is keyed by a random seed chosen
+ *              once per process, so an input cannot be crafted ahead of
+ *              time to make many words collide.  Set HASH_SEED in the
+ *              environment to a number to get the same hashes every run.
+ */
+
+# ifndef HASH_H
+# define HASH_H
+
+unsigned long long strhash64(char *s);
+
+unsigned strhash(char *s);
+
+# endif /* HASH_H */
@@ -0,0 +1,261 @@
+/*
+ * File:        hashbench.c
+ *
+ * Description: This file contains the main function for comparing the
+ *              string hash in hash.c with the old strhash used by the
+ *              sets, which computed hash = 31 * hash + c a byte at a time.
+ *
+ *              The program takes any number of files as command line
+ *              arguments.  For each file, and then for a set of words
+ *              crafted so that the old hash sends all of them to the same
+ *              value, it prints the time to hash every word and the mean
+ *              number of probes to find each distinct word in a linear
+ *              probing table that is half full.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <assert.h>
+# include <time.h>
+# include "reader.h"
+# include "hash.h"
+
+# define ROUNDS 20		/* times each word is hashed when timed */
+# define CRAFTED 12		/* pairs in each of the 2^CRAFTED crafted words */
+
+static volatile unsigned sink;	/* keeps timed hashes from being removed */
+
+
+/* Words read from one file, and how many of them are distinct. */
+
+struct corpus {
+    char **words;		/* every word in order             */
+    int nwords;			/* number of words                 */
+    char **distinct;		/* each distinct word once         */
+    int ndistinct;		/* number of distinct words        */
+};
+
+
+/*
+ * Function:    oldhash
+ *
+ * Description: Return the hash value the sets used to compute for a
+ *		string S.
+ */
+
+static unsigned oldhash(char *s)
+{
+    unsigned hash = 0;
+
+
+    while (*s != '\0')
+        hash = 31 * hash + *s ++;
+
+    return hash;
+}
+
+
+/*
+ * Function:    addWord
+ *
+ * Description: Append a copy of the word S to the array at *WORDS, which
+ *		holds N words and has room for *LENGTH.
+ */
+
+static void addWord(char ***words, int n, int *length, char *s)
+{
+    if (n == *length) {
+	*length = *length == 0 ? 1024 : *length * 2;
+	*words = realloc(*words, sizeof(char *) * *length);
+	assert(*words != NULL);
+    }
+
+    (*words)[n] = strdup(s);
+    assert((*words)[n] != NULL);
+}
+
+
+/*
+ * Function:    compare
+ *
+ * Description: Compare the strings pointed to by A and B for qsort.
+ */
+
+static int compare(const void *a, const void *b)
+{
+    return strcmp(*(char **) a, *(char **) b);
+}
+
+
+/*
+ * Function:    findDistinct
+ *
+ * Description: Fill in the distinct words of the corpus pointed to by CP
+ *		from its words.
+ */
+
+static void findDistinct(struct corpus *cp)
+{
+    int i, n;
+
+
+    cp->distinct = malloc(sizeof(char *) * (cp->nwords + 1));
+    assert(cp->distinct != NULL);
+    memcpy(cp->distinct, cp->words, sizeof(char *) * cp->nwords);
+    qsort(cp->distinct, cp->nwords, sizeof(char *), compare);
+
+    for (i = n = 0; i < cp->nwords; i ++)
+	if (n == 0 || strcmp(cp->distinct[i], cp->distinct[n - 1]) != 0)
+	    cp->distinct[n ++] = cp->distinct[i];
+
+    cp->ndistinct = n;
+}
+
+
+/*
+ * Function:    timeHash
+ *
+ * Description: Return the mean time in nanoseconds that HASH takes on a
+ *		word of the corpus pointed to by CP.
+ */
+
+static double timeHash(struct corpus *cp, unsigned (*hash)(char *))
+{
+    struct timespec start, stop;
+    unsigned sum = 0;
+    int i, j;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (j = 0; j < ROUNDS; j ++)
+	for (i = 0; i < cp->nwords; i ++)
+	    sum += hash(cp->words[i]);
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    sink = sum;
+
+    return ((stop.tv_sec - start.tv_sec) * 1e9 +
+	(stop.tv_nsec - start.tv_nsec)) / ROUNDS / (cp->nwords ? cp->nwords : 1);
+}
+
+
+/*
+ * Function:    probeHash
+ *
+ * Description: Insert the distinct words of the corpus pointed to by CP
+ *		into a linear probing table twice their number using HASH,
+ *		and return the mean number of probes each one took.
+ */
+
+static double probeHash(struct corpus *cp, unsigned (*hash)(char *))
+{
+    char *used;
+    int i, length;
+    long locn, probes;
+
+
+    length = cp->ndistinct * 2 + 1;
+    used = calloc(length, sizeof(char));
+    assert(used != NULL);
+    probes = 0;
+
+    for (i = 0; i < cp->ndistinct; i ++) {
+	locn = hash(cp->distinct[i]) % length;
+	probes ++;
+
+	while (used[locn]) {
+	    locn = (locn + 1) % length;
+	    probes ++;
+	}
+
+	used[locn] = 1;
+    }
+
+    free(used);
+    return cp->ndistinct ? (double) probes / cp->ndistinct : 0;
+}
+
+
+/*
+ * Function:    report
+ *
+ * Description: Print the times and probes of both hashes for the corpus
+ *		pointed to by CP under the name NAME, then free it.
+ */
+
+static void report(char *name, struct corpus *cp)
+{
+    int i;
+
+
+    findDistinct(cp);
+
+    printf("%-30s %8d %8d %8.1f %8.1f %10.2f %10.2f\n", name, cp->nwords,
+	cp->ndistinct, timeHash(cp, oldhash), timeHash(cp, strhash),
+	probeHash(cp, oldhash), probeHash(cp, strhash));
+
+    for (i = 0; i < cp->nwords; i ++)
+	free(cp->words[i]);
+
+    free(cp->words);
+    free(cp->distinct);
+}
+
+
+/*
+ * Function:    main
+ *
+ * Description: Driver function for the benchmark.
+ */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    READER *rp;
+    struct corpus corpus;
+    char *buffer, word[2 * CRAFTED + 1];
+    int i, j, length;
+
+
+    printf("%-30s %8s %8s %8s %8s %10s %10s\n", "", "words", "distinct",
+	"old ns", "new ns", "old probes", "new probes");
+
+    for (i = 1; i < argc; i ++) {
+	if ((fp = fopen(argv[i], "r")) == NULL) {
+	    fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[i]);
+	    continue;
+	}
+
+	corpus.words = NULL;
+	corpus.nwords = length = 0;
+	rp = createReader(fp);
+
+	while ((buffer = readWord(rp, NULL)) != NULL)
+	    addWord(&corpus.words, corpus.nwords ++, &length, buffer);
+
+	destroyReader(rp);
+	fclose(fp);
+	report(argv[i], &corpus);
+    }
+
+
+    /* "Aa" and "BB" have the same old hash, so every string of CRAFTED of
+       them does too. */
+
+    corpus.words = NULL;
+    corpus.nwords = length = 0;
+
+    for (i = 0; i < 1 << CRAFTED; i ++) {
+	for (j = 0; j < CRAFTED; j ++)
+	    memcpy(word + 2 * j, i >> j & 1 ? "BB" : "Aa", 2);
+
+	word[2 * CRAFTED] = '\0';
+	addWord(&corpus.words, corpus.nwords ++, &length, word);
+    }
+
+    report("(crafted)", &corpus);
+    exit(EXIT_SUCCESS);
+}
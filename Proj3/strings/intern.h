@@ -0,0 +1,21 @@
+/*
+ * File:        intern.h
+ *
+ * Description: This file contains the public function declarations for
+ *              interning strings in a set.  Each element of the set has an
+ *              id, a small integer that can stand for it in arrays and
+ *              other structures in place of the string.  Ids are reused
+ *              once their elements are removed, so they are always less
+ *              than the most elements the set has held at once.
+ */
+
+# ifndef INTERN_H
+# define INTERN_H
+
+# include "set.h"
+
+unsigned intern(SET *sp, char *elt);
+
+char *lookupId(SET *sp, unsigned id);
+
+# endif /* INTERN_H */
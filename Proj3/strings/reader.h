@@ -0,0 +1,23 @@
+/*
+ * File:        reader.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for a word reader.  A reader splits an open
+ *              file into words separated by whitespace, as fscanf's %s
+ *              does, but hands back each word in place in its own buffer.
+ */
+
+# ifndef READER_H
+# define READER_H
+
+# include <stdio.h>
+
+typedef struct reader READER;
+
+READER *createReader(FILE *fp);
+
+void destroyReader(READER *rp);
+
+char *readWord(READER *rp, int *len);
+
+# endif /* READER_H */
@@ -0,0 +1,235 @@
+/*
+ *  File: robin.c
+ *  Description: This implementation of a set uses a Robin Hood hash table of strings.
+ *          Each slot records how far its element is from its home slot. An insert takes
+ *          the slot of any element closer to home than itself and carries that element on,
+ *          so probe lengths stay even, and a search stops as soon as it meets an element
+ *          closer to home than the one it is looking for would be.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdbool.h>
+#include "set.h"
+#include "hash.h"
+
+struct set{
+	char **data; /* Data */
+	unsigned *hash; /* Hash of each element, compared before the element */
+	int *dist; /* Distance of each element from its home slot, -1 if empty */
+	int count; /* Count of elements */
+	int length; /* length */
+};
+
+static int search (SET *sp, char *elt, unsigned hash, bool *found);
+
+/*
+ * Function Name: createSet
+ * Time Complexity: O(n)
+ * Description: Create a hashtable with every slot empty
+ */
+
+SET *createSet(int maxElts)
+{
+	SET *sp;
+	sp = malloc(sizeof(SET)); /* Create Set */
+	assert(sp != NULL);
+	sp -> count = 0; /* Set count to 0 */
+	sp -> length = maxElts; /* Set length to max elements */
+	sp -> data = malloc(sizeof(char *) * maxElts); /* Allocate array of data */
+	assert(sp -> data != NULL);
+	sp -> hash = malloc(sizeof(unsigned) * maxElts); /* Allocate array of hashes */
+	assert(sp -> hash != NULL);
+	sp -> dist = malloc(sizeof(int) * maxElts); /* Allocate array of distances */
+	assert(sp -> dist != NULL);
+	for(int i = 0; i<maxElts; i++)  /* Set every slot to empty */
+		sp->dist[i] = -1;
+	return sp;
+}
+
+/*
+ * Function Name: destroySet
+ * Time Complexity: O(n)
+ * Description: Free every data point, the arrays, and the hashtable
+ */
+
+void destroySet(SET *sp)
+{
+	assert(sp != NULL);
+	int i;
+	for(i=0; i < sp-> length; i++)  /* Free data only if it is there */
+	{
+		if(sp->dist[i] >= 0)
+			free(sp->data[i]);
+	}
+	free(sp->data); /* Free data */
+	free(sp->hash); /* Free hashes */
+	free(sp->dist); /* Free distances */
+	free(sp); /* Free set */
+}
+
+/*
+ * Function Name: numElements
+ * Time Complexity: O(1)
+ * Description: Get the number of elements in the set
+ */
+
+int numElements(SET *sp)
+{
+	assert(sp != NULL);
+	return sp-> count;
+}
+
+/*
+ * Function Name: addElement
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Add an element to the set, increment count. From where the search stopped,
+ *          the element being placed swaps with any element nearer its home slot, and the
+ *          element swapped out is placed the same way further on.
+ */
+
+void addElement(SET *sp, char *elt)
+{
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	char *newElt, *tempElt;
+	unsigned hash = strhash(elt), tempHash;
+	int dist, tempDist;
+	int index = search(sp,elt,hash,&found); /* Search for element */
+	if(found) /* Nothing to do if it is there */
+		return;
+	assert(sp->count < sp->length);
+	newElt = strdup(elt);
+	assert(newElt != NULL);
+	dist = (index - (int) (hash % sp->length) + sp->length) % sp->length;
+	while(sp->dist[index] >= 0){ /* Carry on until an empty slot */
+		if(sp->dist[index] < dist){ /* Take slot from element nearer home */
+			tempElt = sp->data[index];
+			tempHash = sp->hash[index];
+			tempDist = sp->dist[index];
+			sp->data[index] = newElt;
+			sp->hash[index] = hash;
+			sp->dist[index] = dist;
+			newElt = tempElt;
+			hash = tempHash;
+			dist = tempDist;
+		}
+		index = (index + 1) % sp->length;
+		dist++;
+	}
+	sp->data[index] = newElt;
+	sp->hash[index] = hash;
+	sp->dist[index] = dist;
+	sp->count ++;
+}
+
+/*
+ * Function Name: addElements
+ * Time Complexity: O(m) average, O(mn) worst case
+ * Description: Add a batch of elements to the set, one at a time
+ */
+
+void addElements(SET *sp, char **elts, int n)
+{
+	assert((sp != NULL) && ((elts != NULL) || (n == 0)));
+	int i;
+	for(i=0; i<n; i++)
+		addElement(sp, elts[i]);
+}
+
+/*
+ * Function Name: removeElement
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Remove an element from the set, decrement count, and shift each later element
+ *          of its run back one slot until an empty slot or an element already at home
+ */
+
+void removeElement(SET *sp, char *elt)
+{
+	assert((sp!= NULL) && (elt != NULL));
+	bool found;
+	int next;
+	int index = search(sp, elt, strhash(elt), &found); /* Search for element */
+	if(!found)
+		return;
+	free(sp->data[index]);
+	next = (index + 1) % sp->length;
+	while(sp->dist[next] > 0){
+		sp->data[index] = sp->data[next];
+		sp->hash[index] = sp->hash[next];
+		sp->dist[index] = sp->dist[next] - 1;
+		index = next;
+		next = (next + 1) % sp->length;
+	}
+	sp->dist[index] = -1;
+	sp->count--;
+}
+
+/*
+ * Function Name: findElement
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Find element in the set, return the pointer to the element if found, else return NULL
+ */
+
+char *findElement (SET *sp, char *elt)
+{
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int index = search(sp, elt, strhash(elt), &found);
+	if(!found) {
+		return NULL;
+	}
+	return sp->data[index];
+}
+
+/*
+ * Function Name: getElements
+ * Time Complexity: O(n)
+ * Description: Create a soft copy of the elements in the set.
+ */
+
+char **getElements(SET *sp)
+{
+	assert(sp != NULL);
+	char **dataCopy;
+	dataCopy = malloc(sizeof(char *)*(sp->count + 1));
+	assert(dataCopy != NULL);
+	int i, j;
+	for(i=0, j=0;i<sp->length;i++){ /* Pack filled slots to the front */
+		if(sp->dist[i] >= 0) {
+			dataCopy[j++] = sp->data[i];
+		}
+	}
+	return dataCopy;
+}
+
+/*
+ * Function Name: search
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Search for element in set with its hash, using linear probing.
+ *          Return index if found, else return index where element would be inserted.
+ *          Stop early at an empty slot or at an element nearer its home than elt would be,
+ *          since elt would have taken that slot. Use a pass-by-reference variable to tell
+ *          client if the element is found.
+ */
+
+static int search (SET *sp, char *elt, unsigned hash, bool *found)
+{
+	int locn = hash % sp->length;
+	int dist;
+	for(dist=0; dist<sp->length; dist++){
+		if(sp->dist[locn] < dist) { /* Case to stop searching */
+			*found = false;
+			return locn;
+		}
+		if(sp->hash[locn] == hash && strcmp(sp->data[locn],elt) == 0){ /* Case found */
+			*found = true;
+			return locn;
+		}
+		locn = (locn + 1) % sp->length;
+	}
+	*found = false;
+	return -1;
+}
@@ -0,0 +1,348 @@
+/*
+ *  File: swiss.c
+ *  Description: This implementation of a set uses a hash table of strings split into groups
+ *          of 16 slots, in the style of SwissTable. Each slot has a control byte that is
+ *          EMPTY, DELETED, or 7 bits of the element's hash. A probe loads the 16 control
+ *          bytes of a group and compares them all at once, so only slots whose 7 bits match
+ *          are compared as strings, and a group with an empty slot ends the search.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <stdbool.h>
+#include "set.h"
+#include "hash.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define GROUP 16 /* Slots in a group */
+#define EMPTY ((signed char) 0x80) /* Control byte of an empty slot */
+#define DELETED ((signed char) 0xFE) /* Control byte of a deleted slot */
+
+struct set{
+	char **data; /* Data */
+	signed char *ctrl; /* Control byte of each slot, 7 bits of hash if filled */
+	int count; /* Count of elements */
+	int deleted; /* Count of deleted slots */
+	int length; /* length, a power of two groups */
+	int limit; /* Most filled and deleted slots before rehashing */
+};
+
+static int search (SET *sp, char *elt, unsigned hash, bool *found);
+static int findFree (SET *sp, unsigned hash);
+static void rehash (SET *sp);
+static unsigned mix (unsigned hash);
+static unsigned match (signed char *ctrl, signed char byte);
+static unsigned matchFree (signed char *ctrl);
+
+/*
+ * Function Name: createSet
+ * Time Complexity: O(n)
+ * Description: Create a hashtable with a power of two groups, at most 7/8 full with maxElts
+ */
+
+SET *createSet(int maxElts)
+{
+	SET *sp;
+	sp = malloc(sizeof(SET)); /* Create Set */
+	assert(sp != NULL);
+	sp -> count = 0; /* Set count to 0 */
+	sp -> deleted = 0;
+	sp -> length = GROUP;
+	while(sp->length / 8 * 7 < maxElts) /* Room for maxElts at 7/8 load */
+		sp->length *= 2;
+	sp -> limit = sp->length / 8 * 7;
+	sp -> ctrl = aligned_alloc(GROUP, sp->length); /* Allocate array of control bytes */
+	assert(sp -> ctrl != NULL);
+	sp -> data = malloc(sizeof(char *) * sp->length); /* Allocate array of data */
+	assert(sp -> data != NULL);
+	memset(sp->ctrl, EMPTY, sp->length); /* Set every slot to empty */
+	return sp;
+}
+
+/*
+ * Function Name: destroySet
+ * Time Complexity: O(n)
+ * Description: Free every data point, control array, and hashtable
+ */
+
+void destroySet(SET *sp)
+{
+	assert(sp != NULL);
+	int i;
+	for(i=0; i < sp-> length; i++)  /* Free data only if it is there */
+	{
+		if(sp->ctrl[i] >= 0)
+			free(sp->data[i]);
+	}
+	free(sp->data); /* Free data */
+	free(sp->ctrl); /* Free control bytes */
+	free(sp); /* Free set */
+}
+
+/*
+ * Function Name: numElements
+ * Time Complexity: O(1)
+ * Description: Get the number of elements in the set
+ */
+
+int numElements(SET *sp)
+{
+	assert(sp != NULL);
+	return sp-> count;
+}
+
+/*
+ * Function Name: addElement
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Add an element to the first free slot on its probe sequence, increment count.
+ *          Deleted slots are cleared out by rehashing once too few empty slots are left.
+ */
+
+void addElement(SET *sp, char *elt)
+{
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	char *newElt;
+	unsigned hash = mix(strhash(elt));
+	int index;
+	search(sp, elt, hash, &found); /* Search for element */
+	if(found) /* Nothing to do if it is there */
+		return;
+	if(sp->count + sp->deleted >= sp->limit)
+		rehash(sp);
+	assert(sp->count < sp->limit);
+	newElt = strdup(elt);
+	assert(newElt != NULL);
+	index = findFree(sp, hash);
+	if(sp->ctrl[index] == DELETED)
+		sp->deleted--;
+	sp->data[index] = newElt;
+	sp->ctrl[index] = hash & 0x7F;
+	sp->count ++;
+}
+
+/*
+ * Function Name: addElements
+ * Time Complexity: O(m) average, O(mn) worst case
+ * Description: Add a batch of elements to the set, one at a time
+ */
+
+void addElements(SET *sp, char **elts, int n)
+{
+	assert((sp != NULL) && ((elts != NULL) || (n == 0)));
+	int i;
+	for(i=0; i<n; i++)
+		addElement(sp, elts[i]);
+}
+
+/*
+ * Function Name: removeElement
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Remove an element from the set, decrement count. The slot can only be made
+ *          empty again if its group still has an empty slot, since then no search has ever
+ *          had to go past the group; otherwise it is marked deleted.
+ */
+
+void removeElement(SET *sp, char *elt)
+{
+	assert((sp!= NULL) && (elt != NULL));
+	bool found;
+	int index = search(sp, elt, mix(strhash(elt)), &found); /* Search for element */
+	if(!found)
+		return;
+	free(sp->data[index]);
+	if(match(sp->ctrl + index / GROUP * GROUP, EMPTY) != 0)
+		sp->ctrl[index] = EMPTY;
+	else {
+		sp->ctrl[index] = DELETED;
+		sp->deleted++;
+	}
+	sp->count--;
+}
+
+/*
+ * Function Name: findElement
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Find element in the set, return the pointer to the element if found, else return NULL
+ */
+
+char *findElement (SET *sp, char *elt)
+{
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int index = search(sp, elt, mix(strhash(elt)), &found);
+	if(!found) {
+		return NULL;
+	}
+	return sp->data[index];
+}
+
+/*
+ * Function Name: getElements
+ * Time Complexity: O(n)
+ * Description: Create a soft copy of the elements in the set.
+ */
+
+char **getElements(SET *sp)
+{
+	assert(sp != NULL);
+	char **dataCopy;
+	dataCopy = malloc(sizeof(char *)*(sp->count + 1));
+	assert(dataCopy != NULL);
+	int i, j;
+	for(i=0, j=0;i<sp->length;i++){ /* Pack filled slots to the front */
+		if(sp->ctrl[i] >= 0) {
+			dataCopy[j++] = sp->data[i];
+		}
+	}
+	return dataCopy;
+}
+
+/*
+ * Function Name: search
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Search for element in set with its hash. The high bits pick the first group
+ *          and later groups are visited 1, 2, 3, ... groups apart, which reaches every group
+ *          of a power of two table. Return index if found, else -1. Use a pass-by-reference
+ *          variable to tell client if the element is found.
+ */
+
+static int search (SET *sp, char *elt, unsigned hash, bool *found)
+{
+	int groups = sp->length / GROUP;
+	int group = (hash >> 7) & (groups - 1);
+	int i, index;
+	unsigned bits;
+	for(i=0; i<groups; i++){
+		/* Compare every slot whose 7 bits match */
+		bits = match(sp->ctrl + group * GROUP, hash & 0x7F);
+		while(bits != 0){
+			index = group * GROUP + __builtin_ctz(bits);
+			if(strcmp(sp->data[index], elt) == 0){ /* Case found */
+				*found = true;
+				return index;
+			}
+			bits &= bits - 1;
+		}
+		if(match(sp->ctrl + group * GROUP, EMPTY) != 0) /* Case to stop searching */
+			break;
+		group = (group + i + 1) & (groups - 1);
+	}
+	*found = false;
+	return -1;
+}
+
+/*
+ * Function Name: findFree
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Return the first empty or deleted slot on the probe sequence of a hash
+ */
+
+static int findFree (SET *sp, unsigned hash)
+{
+	int groups = sp->length / GROUP;
+	int group = (hash >> 7) & (groups - 1);
+	int i;
+	unsigned bits;
+	for(i=0; i<groups; i++){
+		bits = matchFree(sp->ctrl + group * GROUP);
+		if(bits != 0)
+			return group * GROUP + __builtin_ctz(bits);
+		group = (group + i + 1) & (groups - 1);
+	}
+	return -1;
+}
+
+/*
+ * Function Name: rehash
+ * Time Complexity: O(n)
+ * Description: Reinsert every element into a table of the same length with no deleted slots
+ */
+
+static void rehash (SET *sp)
+{
+	char **data = sp->data;
+	signed char *ctrl = sp->ctrl;
+	int i, index;
+	unsigned hash;
+	sp->ctrl = aligned_alloc(GROUP, sp->length);
+	assert(sp->ctrl != NULL);
+	sp->data = malloc(sizeof(char *) * sp->length);
+	assert(sp->data != NULL);
+	memset(sp->ctrl, EMPTY, sp->length);
+	for(i=0; i<sp->length; i++){
+		if(ctrl[i] >= 0){
+			hash = mix(strhash(data[i]));
+			index = findFree(sp, hash);
+			sp->data[index] = data[i];
+			sp->ctrl[index] = hash & 0x7F;
+		}
+	}
+	sp->deleted = 0;
+	free(data);
+	free(ctrl);
+}
+
+/*
+ * Function Name: mix
+ * Time Complexity: O(1)
+ * Description: Spread the bits of a hash, so that the 7 bits kept in the control byte and
+ *          the bits picking the group are not related
+ */
+
+static unsigned mix (unsigned hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+/*
+ * Function Name: match
+ * Time Complexity: O(1)
+ * Description: Return a bit mask of the slots in a group whose control byte is byte
+ */
+
+static unsigned match (signed char *ctrl, signed char byte)
+{
+#ifdef __SSE2__
+	__m128i group = _mm_load_si128((__m128i *) ctrl);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte)));
+#else
+	unsigned bits = 0;
+	int i;
+	for(i=0; i<GROUP; i++)
+		if(ctrl[i] == byte)
+			bits |= 1u << i;
+	return bits;
+#endif
+}
+
+/*
+ * Function Name: matchFree
+ * Time Complexity: O(1)
+ * Description: Return a bit mask of the empty or deleted slots in a group, which are the
+ *          only control bytes with the high bit set
+ */
+
+static unsigned matchFree (signed char *ctrl)
+{
+#ifdef __SSE2__
+	return _mm_movemask_epi8(_mm_load_si128((__m128i *) ctrl));
+#else
+	unsigned bits = 0;
+	int i;
+	for(i=0; i<GROUP; i++)
+		if(ctrl[i] < 0)
+			bits |= 1u << i;
+	return bits;
+#endif
+}
@@ -3,6 +3,13 @@
  *  Name: Lyman Shen
  *  Date: 5/4/17
  *  Description: This implementation of a set uses a hash table of strings to store the data.
+ *          Each slot fills half a cache line and holds the element's hash, id and length,
+ *          with the element itself if it is short enough, so finding a short word touches
+ *          only its slot. Longer elements are kept in an arena and the slot points to them.
+ *          The ids, declared in intern.h, are small integers that index an array of slots.
+ *          The table doubles once it is 3/4 full. Rather than moving every element at once,
+ *          each later change moves a few slots of the old table into the new one, and until
+ *          the old table is empty a search that misses in the new table looks in it too.
  */
 
 #include <stdio.h>
@@ -10,22 +17,62 @@
 #include <assert.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "set.h"
+#include "intern.h"
+#include "hash.h"
+#include "arena.h"
+
+#define INLINE 16 /* Size of an element kept in its slot, with its terminator */
+#define LONG 255 /* Length recorded for an element kept in the arena */
+#define EMPTY '\0' /* Flag for an empty slot, so a table from calloc starts empty */
+#define MIGRATE 16 /* Slots of the old table moved by each change while growing */
+#define PAGE 4096 /* Ids in each page of where */
+
+struct slot{
+	unsigned hash; /* Hash of element, compared before the element */
+	unsigned id; /* Id of element */
+	char flag; /* Flag for slot */
+	unsigned char size; /* Length of element, or LONG if it is in the arena */
+	union{
+		char text[INLINE]; /* Element, if shorter than INLINE */
+		char *data; /* Element in the arena, otherwise */
+	};
+};
 
 struct set{
-	char **data; /* Data */
-	char *flag; /* Flags for data */
+	struct slot *slots; /* Slots, aligned to a cache line */
+	void *block; /* Memory holding slots */
 	int count; /* Count of elements */
-	int length; /* length */
+	int length; /* length, a power of two */
+	ARENA *arena; /* storage for the strings */
+	int **where; /* Pages of the slot of each id in use, or the next free id */
+	int ids; /* Count of ids ever given out */
+	int freeId; /* Id most recently freed, or -1 */
+	struct slot *old; /* Slots still being moved into slots, or NULL */
+	void *oldBlock; /* Memory holding old */
+	int oldLength; /* length of old */
+	int moved; /* Count of slots of old already moved */
 };
 
-static unsigned strhash(char *s);
-static int search (SET *sp, char *elt, bool *found);
+static int search (SET *sp, char *elt, int size, unsigned hash, bool *found);
+static int probe (struct slot *slots, int length, char *elt, int size, unsigned hash, bool *found);
+static struct slot *slotAt (SET *sp, int index);
+static struct slot *allocate (int length, void **block);
+static int *whereOf (SET *sp, unsigned id);
+static void grow (SET *sp);
+static void migrate (SET *sp);
+static char *element (struct slot *slot);
+static void shift (SET *sp, int hole);
+static unsigned mix (unsigned hash);
+static void compact (SET *sp);
 
 /*
  * Function Name: createSet
  * Time Complexity: O(n)
- * Description: Create a hashtable with an appropiate identifier array
+ * Description: Create a hashtable with an appropiate identifier array, long enough to hold
+ *          maxElts before it grows, its length a power of two so a slot can be found with a
+ *          mask instead of a division
  */
 
 SET *createSet(int maxElts)
@@ -34,33 +81,35 @@ SET *createSet(int maxElts)
 	sp = malloc(sizeof(SET)); /* Create Set */
 	assert(sp != NULL);
 	sp -> count = 0; /* Set count to 0 */
-	sp -> length = maxElts; /* Set length to max elements */
-	sp -> flag = malloc(sizeof(char) * maxElts); /* Allocate array of flags */
-	assert(sp -> flag != NULL);
-	sp -> data = malloc(sizeof(char *) * maxElts); /* Allocate array of data */
-	assert(sp -> data != NULL);
-	for(int i = 0; i<maxElts; i++)  /* Set every data to empty */
-		sp->flag[i] = 'E';
+	sp -> length = 2; /* Two slots fill a cache line */
+	while(sp->length / 4 * 3 < maxElts) /* Set length to max elements at 3/4 load, rounded up */
+		sp->length *= 2;
+	sp -> slots = allocate(sp->length, &sp->block); /* Allocate array of empty slots */
+	sp -> arena = createArena();
+	sp -> where = malloc(sizeof(int *) * (sp->length / PAGE + 1)); /* Pages are allocated as needed */
+	assert(sp -> where != NULL);
+	sp -> ids = 0;
+	sp -> freeId = -1;
+	sp -> old = NULL; /* Not growing */
+	sp -> oldBlock = NULL;
 	return sp;
 }
 
 /*
  * Function Name: destroySet
  * Time Complexity: O(n)
- * Description: Free every data point, identifier array, and hashtable
+ * Description: Free the arena holding every data point, identifier array, and hashtable
  */
 
 void destroySet(SET *sp)
 {
 	assert(sp != NULL);
-	int i;
-	for(i=0; i < sp-> length; i++)  /* Free data only if it is there */
-	{
-		if(sp->flag[i] == 'F')
-			free(sp->data[i]);
-	}
-	free(sp->data); /* Free data */
-	free(sp->flag); /* Free flags */
+	destroyArena(sp->arena); /* Free every long data point at once */
+	free(sp->block); /* Free slots */
+	free(sp->oldBlock); /* Free slots not yet moved */
+	for(int i = 0; i<sp->ids; i+=PAGE) /* Free slots by id */
+		free(sp->where[i / PAGE]);
+	free(sp->where);
 	free(sp); /* Free set */
 }
 
@@ -79,57 +128,150 @@ int numElements(SET *sp)
 /*
  * Function Name: addElement
  * Time Complexity: O(1) average, O(n) worst case
- * Description: Add an element to the set, change corresponding identifier, increment count
+ * Description: Add an element to the set
  */
 
 void addElement(SET *sp, char *elt)
+{
+	intern(sp, elt);
+}
+
+/*
+ * Function Name: intern
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Add an element to the set if it is not there, change corresponding identifier,
+ *          increment count, and return its id. A short element is copied into its slot, and a
+ *          long one into the arena. The id is the most recently freed one if there is one, else
+ *          the next unused one, so ids stay below the most elements the set has held at once.
+ *          New elements always go into the new table.
+ */
+
+unsigned intern(SET *sp, char *elt)
 {
 	assert((sp != NULL) && (elt != NULL));
 	bool found;
-	char *newElt;
-	int index = search(sp,elt,&found); /* Search for element */
+	struct slot *slot;
+	int size = strlen(elt);
+	unsigned hash = mix(strhash(elt));
+	int index;
+	if(sp->count >= sp->length / 4 * 3) /* Grow once 3/4 full */
+		grow(sp);
+	migrate(sp);
+	index = search(sp,elt,size,hash,&found); /* Search for element */
+	slot = slotAt(sp, index);
 	if(!found){ /* Add element if it is not there */
-		newElt = strdup(elt);
-		assert(newElt != NULL);
-		sp->data[index] = newElt;
-		sp->flag[index] = 'F'; /* Set flag to filled */
+		if(size < INLINE){
+			memcpy(slot->text, elt, size + 1);
+			slot->size = size;
+		} else {
+			slot->data = copyString(sp->arena, elt);
+			slot->size = LONG;
+		}
+		slot->hash = hash;
+		slot->flag = 'F'; /* Set flag to filled */
+		if(sp->freeId != -1){ /* Reuse freed id */
+			slot->id = sp->freeId;
+			sp->freeId = *whereOf(sp, sp->freeId);
+		} else {
+			if(sp->ids % PAGE == 0){ /* Start a new page of where */
+				sp->where[sp->ids / PAGE] = malloc(sizeof(int) * PAGE);
+				assert(sp->where[sp->ids / PAGE] != NULL);
+			}
+			slot->id = sp->ids++;
+		}
+		*whereOf(sp, slot->id) = index;
 		sp->count ++;
 	}
+	return slot->id;
+}
+
+/*
+ * Function Name: lookupId
+ * Time Complexity: O(1)
+ * Description: Return the element with an id, or NULL if the id is not in use. A free id
+ *          never matches the id of the slot it points at, since no element has it. While
+ *          growing, the slot may be in either table, but only one filled slot has the id.
+ */
+
+char *lookupId(SET *sp, unsigned id)
+{
+	assert((sp != NULL) && (id < (unsigned) sp->ids));
+	int index = *whereOf(sp, id);
+	if(index < 0)
+		return NULL;
+	if(sp->slots[index].flag == 'F' && sp->slots[index].id == id)
+		return element(&sp->slots[index]);
+	if(sp->old != NULL && index < sp->oldLength &&
+		sp->old[index].flag == 'F' && sp->old[index].id == id)
+		return element(&sp->old[index]);
+	return NULL;
+}
+
+/*
+ * Function Name: addElements
+ * Time Complexity: O(m) average, O(mn) worst case
+ * Description: Add a batch of elements to the set, one at a time
+ */
+
+void addElements(SET *sp, char **elts, int n)
+{
+	assert((sp != NULL) && ((elts != NULL) || (n == 0)));
+	int i;
+	for(i=0; i<n; i++)
+		addElement(sp, elts[i]);
 }
 
 /*
  * Function Name: removeElements
  * Time Complexity: O(1) average, O(n) worst case
- * Description: Remove an element from the set, change corresponding identifier, decrement count
+ * Description: Remove an element from the set, decrement count, free its id, and shift back the
+ *          elements after it so no deleted marker is left behind. An element still in the old
+ *          table is only marked deleted, since nothing is ever added there. Once most of the
+ *          arena is released strings, the rest are compacted into a new one. Growing, shifting,
+ *          and compacting all move elements, so pointers to elements are only valid until the
+ *          set next changes.
  */
 
 void removeElement(SET *sp, char *elt)
 {
 	assert((sp!= NULL) && (elt != NULL));
 	bool found;
-	int index = search(sp, elt, &found); /* Search for element */
+	struct slot *slot;
+	int index;
+	migrate(sp);
+	index = search(sp, elt, strlen(elt), mix(strhash(elt)), &found); /* Search for element */
 	if(found){ /* Remove elements if it is there */
-		free(sp->data[index]);
-		sp->flag[index] = 'D'; /* Set flag to deleted */
+		slot = slotAt(sp, index);
+		if(slot->size == LONG)
+			releaseString(sp->arena, slot->data);
+		*whereOf(sp, slot->id) = sp->freeId; /* Free its id */
+		sp->freeId = slot->id;
+		if(index < sp->length)
+			shift(sp, index); /* Fill the hole */
+		else
+			slot->flag = 'D'; /* Leave the hole in the old table */
 		sp->count--;
+		if(needsCompaction(sp->arena))
+			compact(sp);
 	}
 }
 
 /*
  * Function Name: findElement
  * Time Complexity: O(1) average, O(n) worst case
- * Description: Find element in the set, return the pointer to the element if found, else return NULL
+ * Description: Find element in the set, return the pointer to the element if found, else return NULL.
+ *          Finds do not move any slots, so they never pay for growing.
  */
 
 char *findElement (SET *sp, char *elt)
 {
 	assert((sp != NULL) && (elt != NULL));
 	bool found;
-	int index = search(sp, elt, &found);
+	int index = search(sp, elt, strlen(elt), mix(strhash(elt)), &found);
 	if(!found) {
 		return NULL;
 	}
-	return sp->data[index];
+	return element(slotAt(sp, index));
 }
 
 /*
@@ -142,66 +284,244 @@ char **getElements(SET *sp)
 {
 	assert(sp != NULL);
 	char **dataCopy;
-	dataCopy = malloc(sizeof(char *)*sp->length);
-	int i;
-	for(i=0;i<sp->length;i++){
-		if(sp->flag[i] == 'F') {
-			dataCopy[i] = sp->data[i];
+	dataCopy = malloc(sizeof(char *)*(sp->count + 1));
+	assert(dataCopy != NULL);
+	int i, j;
+	for(i=0, j=0;i<sp->length;i++){ /* Pack filled slots to the front */
+		if(sp->slots[i].flag == 'F') {
+			dataCopy[j++] = element(&sp->slots[i]);
+		}
+	}
+	for(i=0;sp->old != NULL && i<sp->oldLength;i++){ /* Then those not yet moved */
+		if(sp->old[i].flag == 'F') {
+			dataCopy[j++] = element(&sp->old[i]);
 		}
 	}
 	return dataCopy;
 }
 
 /*
- * Function Name: strhash
- * Time Complexity: O(1)
- * Description: Map a string in an array index with hash function
+ * Function Name: search
+ * Time Complexity: O(1) average, O(n) worst case
+ * Descriptoin: Search for elemnt in the new table and then, while growing, the old one.
+ *          Return index if found, counting the slots of the old table after those of the new
+ *          one, else return index in the new table where element would be inserted.
+ *          Use a pass-by-reference variable to tell client if the element is found.
  */
 
-static unsigned strhash(char *s){
-	unsigned hash = 0;
-	assert(s != NULL);
-	while(*s != '\0')
-		hash = 31 * hash + *s++;
-	return hash;
+static int search (SET *sp, char *elt, int size, unsigned hash, bool *found)
+{
+	assert((sp!= NULL) && (elt != NULL));
+	int index, locn;
+	if(size >= INLINE)
+		size = LONG;
+	index = probe(sp->slots, sp->length, elt, size, hash, found);
+	if(*found || sp->old == NULL)
+		return index;
+	locn = probe(sp->old, sp->oldLength, elt, size, hash, found);
+	return *found ? sp->length + locn : index;
 }
 
 /*
- * Function Name: search
+ * Function Name: probe
  * Time Complexity: O(1) average, O(n) worst case
- * Descriptoin: Search for elemnt in set with the hash function, using linear probing.
- *          Return index if found, else return index where element would be inserted.
- *          Use a pass-by-reference variable to tell client if the element is found.
+ * Description: Search for element in one table with its hash, using linear probing.
+ *          Return index if found, else return index of the empty slot that ends the search.
+ *          Deleted slots, only found in an old table, do not end it. Elements are only
+ *          compared when their stored hash and length match.
  */
 
-static int search (SET *sp, char *elt, bool *found)
+static int probe (struct slot *slots, int length, char *elt, int size, unsigned hash, bool *found)
 {
-	assert((sp!= NULL) && (elt != NULL));
-	int index = strhash(elt)%sp->length;
-	int deleted = -1;
+	int mask = length - 1;
+	int index = hash & mask;
 	int locn;
 	int i = 0;
-	while(i<sp->length){
-		locn = (index + i) % (sp->length);
-		if(sp->flag[locn] == 'D') {
-			if(deleted == -1) { /* Record first deleted location, otherwise keep searching */
-				deleted = locn;
-			}
-		}
-		else if(sp->flag[locn] == 'E') { /* Case to stop searching */
+	struct slot *slot;
+	while(i<length){
+		locn = (index + i) & mask;
+		slot = &slots[locn];
+		if(slot->flag == EMPTY) { /* Case to stop searching */
 			*found = false;
-			if(deleted == -1) /* Preference to give deleted index if there is one when not found */
-			{
-				return locn;
-			}
-			return deleted;
+			return locn;
 		}
-		else if(strcmp(sp->data[locn],elt) == 0){ /* Case found */
+		else if(slot->flag == 'F' && slot->hash == hash && slot->size == size && (size == LONG ?
+			strcmp(slot->data, elt) : memcmp(slot->text, elt, size)) == 0){ /* Case found */
 			*found = true;
 			return locn;
 		}
 		i++;
 	}
 	*found = false;
-	return deleted;
+	return -1;
+}
+
+/*
+ * Function Name: shift
+ * Time Complexity: O(1) average, O(n) worst case
+ * Description: Empty the slot at hole, moving back each later element in its run that may
+ *          live there, so every element stays reachable from its home slot without gaps.
+ *          Each element moved leaves a new hole behind it, until the run ends.
+ */
+
+static void shift (SET *sp, int hole)
+{
+	int mask = sp->length - 1;
+	int locn = hole;
+	int home, i;
+	for(i=1; i<sp->length; i++){ /* Stop after one lap of a full table */
+		locn = (locn + 1) & mask;
+		if(sp->slots[locn].flag == EMPTY) /* End of run */
+			break;
+		home = sp->slots[locn].hash & mask;
+		/* Move back only if hole lies between home and locn */
+		if(((locn - home) & mask) >= ((locn - hole) & mask)){
+			sp->slots[hole] = sp->slots[locn];
+			*whereOf(sp, sp->slots[hole].id) = hole;
+			hole = locn;
+		}
+	}
+	sp->slots[hole].flag = EMPTY;
+}
+
+/*
+ * Function Name: mix
+ * Time Complexity: O(1)
+ * Description: Spread the bits of a hash, so that the low bits picking the home slot
+ *          depend on every bit of the string's hash
+ */
+
+static unsigned mix (unsigned hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+/*
+ * Function Name: compact
+ * Time Complexity: O(n)
+ * Description: Copy the long strings into a new arena in the order of their slots and free
+ *          the old one, along with the space of every string released from it
+ */
+
+static void compact (SET *sp)
+{
+	ARENA *arena = createArena();
+	int i;
+	for(i=0; i<sp->length; i++){
+		if(sp->slots[i].flag == 'F' && sp->slots[i].size == LONG)
+			sp->slots[i].data = copyString(arena, sp->slots[i].data);
+	}
+	for(i=0; sp->old != NULL && i<sp->oldLength; i++){
+		if(sp->old[i].flag == 'F' && sp->old[i].size == LONG)
+			sp->old[i].data = copyString(arena, sp->old[i].data);
+	}
+	destroyArena(sp->arena);
+	sp->arena = arena;
+}
+
+/*
+ * Function Name: element
+ * Time Complexity: O(1)
+ * Description: Return the element in a filled slot, wherever it is kept
+ */
+
+static char *element (struct slot *slot)
+{
+	return slot->size == LONG ? slot->data : slot->text;
+}
+
+/*
+ * Function Name: slotAt
+ * Time Complexity: O(1)
+ * Description: Return the slot at an index from search, which may be in the old table
+ */
+
+static struct slot *slotAt (SET *sp, int index)
+{
+	return index < sp->length ? &sp->slots[index] : &sp->old[index - sp->length];
+}
+
+/*
+ * Function Name: whereOf
+ * Time Complexity: O(1)
+ * Description: Return where the slot of an id is kept. The ids are split into pages, so more
+ *          ids can be added by adding pages without moving the ones there already.
+ */
+
+static int *whereOf (SET *sp, unsigned id)
+{
+	return &sp->where[id / PAGE][id % PAGE];
+}
+
+/*
+ * Function Name: grow
+ * Time Complexity: O(1) amortized
+ * Description: Make the table the old one and start an empty table twice as long. No element
+ *          is moved yet, and only the list of pages of where is copied, not the pages. The last
+ *          old table is always empty by now, so growing never moves every element at once.
+ */
+
+static void grow (SET *sp)
+{
+	assert(sp->old == NULL); /* Last old table must be empty already, see migrate */
+	sp->old = sp->slots;
+	sp->oldBlock = sp->block;
+	sp->oldLength = sp->length;
+	sp->moved = 0;
+	sp->length *= 2;
+	sp->slots = allocate(sp->length, &sp->block); /* Allocate array of empty slots */
+	sp->where = realloc(sp->where, sizeof(int *) * (sp->length / PAGE + 1)); /* Room for more pages */
+	assert(sp->where != NULL);
+}
+
+/*
+ * Function Name: migrate
+ * Time Complexity: O(1) average
+ * Description: Move the next MIGRATE slots of the old table into the new one, marking them
+ *          deleted in the old table, and free the old table once every slot is moved. The new
+ *          table has 3/4 of its length to fill before it must grow, and the old table is only
+ *          half its length, so it is always empty well before then.
+ */
+
+static void migrate (SET *sp)
+{
+	int mask = sp->length - 1;
+	int i, locn;
+	struct slot *slot;
+	for(i=0; i<MIGRATE && sp->old != NULL; i++){
+		slot = &sp->old[sp->moved];
+		if(slot->flag == 'F'){ /* Insert into first empty slot from home */
+			locn = slot->hash & mask;
+			while(sp->slots[locn].flag != EMPTY)
+				locn = (locn + 1) & mask;
+			sp->slots[locn] = *slot;
+			*whereOf(sp, slot->id) = locn;
+			slot->flag = 'D';
+		}
+		if(++sp->moved == sp->oldLength){ /* Old table is empty */
+			free(sp->oldBlock);
+			sp->old = NULL;
+			sp->oldBlock = NULL;
+		}
+	}
+}
+
+/*
+ * Function Name: allocate
+ * Time Complexity: O(1) for a large table
+ * Description: Return an array of empty slots aligned to a cache line, and the memory holding
+ *          it in block. It comes from calloc, which gets a large table as fresh pages that are
+ *          already zero, so it is not cleared all at once when the table grows.
+ */
+
+static struct slot *allocate (int length, void **block)
+{
+	*block = calloc(sizeof(struct slot) * length + 63, 1);
+	assert(*block != NULL);
+	return (struct slot *) (((uintptr_t) *block + 63) & ~(uintptr_t) 63);
 }
@@ -12,18 +12,305 @@
  *              total words in the set are printed.  If the second file is
  *              given then all words in the second file are deleted from
  *              the set and the count printed.
+ *
+ *              With -a the set is not built at all.  The number of
+ *              distinct words is instead estimated in one pass with a
+ *              HyperLogLog sketch, which uses a few kilobytes no matter
+ *              how many distinct words there are.
+ *
+ *              In batch mode, with -b and any number of files or with -f
+ *              and a file listing their names, each file is counted on its
+ *              own by a pool of threads (-j sets how many).  The counts of
+ *              each file are printed in order, followed by the total words.
+ *              Only with -a is the number of distinct words across all the
+ *              files given, estimated by merging the sketches; an exact
+ *              figure would need every file's words kept at once.
+ *
+ *              With -c and a cache file, the counts of each file are kept
+ *              in the cache and a file is only read again if its size or
+ *              modification time has changed.
  */
 
 # include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
 # include <stdbool.h>
+# include <assert.h>
+# include <pthread.h>
+# include <sys/stat.h>
 # include "set.h"
+# include "reader.h"
+# include "hll.h"
+# include "cache.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
 
 # define MAX_SIZE 18000
+# define MAX_THREADS 256
+# define BATCH_SIZE 65536
+# define POOL_SIZE (1 << 20)
+
+
+/* One file counted in batch mode. */
+
+struct job {
+    char *path;			/* name of the file                */
+    int words;			/* total words, or -1 if unreadable */
+    int distinct;		/* number of distinct words        */
+    HLL *sketch;		/* sketch of the words if -a given */
+};
+
+
+/* Files shared by the threads of a batch. */
+
+struct batch {
+    struct job *jobs;		/* array of files to count         */
+    int njobs;			/* number of files                 */
+    int next;			/* next file to hand out           */
+    bool aflag;			/* sketch instead of building sets */
+    CACHE *cache;		/* cached results, or NULL         */
+    pthread_mutex_t lock;	/* protects next                   */
+};
+
+
+/*
+ * Function:    loadFile
+ *
+ * Description: Insert every word read by RP into the set pointed to by SP
+ *		and return the total number of words.  The words are copied
+ *		into a pool and handed to the set in large batches, so a set
+ *		that can add a batch at once does not pay for every word.
+ */
+
+static int loadFile(SET *sp, READER *rp)
+{
+    char *buffer, *pool, **elts;
+    int n, len, words;
+    size_t used, size, need;
+
+
+    words = n = 0;
+    used = 0;
+    size = POOL_SIZE;
+
+    pool = malloc(size);
+    assert(pool != NULL);
+    elts = malloc(sizeof(char *) * BATCH_SIZE);
+    assert(elts != NULL);
+
+    while ((buffer = readWord(rp, &len)) != NULL) {
+	words ++;
+	need = len + 1;
+
+	if (n == BATCH_SIZE || used + need > size) {
+	    addElements(sp, elts, n);
+	    n = 0;
+	    used = 0;
+
+	    if (need > size) {
+		size = need;
+		free(pool);
+		pool = malloc(size);
+		assert(pool != NULL);
+	    }
+	}
+
+	elts[n ++] = memcpy(pool + used, buffer, need);
+	used += need;
+    }
+
+    addElements(sp, elts, n);
+    free(elts);
+    free(pool);
+    return words;
+}
+
+
+/*
+ * Function:    countFile
+ *
+ * Description: Count the total and distinct words in the file of the job
+ *		pointed to by JP.  If AFLAG is true then the distinct words
+ *		are only sketched.  If CACHE is not NULL then a cached result
+ *		is used if there is one, and a new result is cached.
+ */
+
+static void countFile(struct job *jp, bool aflag, CACHE *cache)
+{
+    FILE *fp;
+    READER *rp;
+    struct stat st;
+    long words, distinct;
+    char *kind, *data, text[HLL_LENGTH + 1];
+    char *buffer;
+    SET *unique;
+
+
+    jp->words = -1;
+    kind = aflag ? "unique-a" : "unique";
+
+
+    /* Take the status before reading, so a result is never cached under
+       the size and time of contents it was not counted from. */
+
+    if (cache != NULL && stat(jp->path, &st) < 0)
+	cache = NULL;
+
+    if (cache != NULL && findEntry(cache, kind, jp->path, &st, &words, &distinct, &data)) {
+	jp->words = words;
+	jp->distinct = distinct;
+
+	if (aflag) {
+	    jp->sketch = createHLL();
+
+	    if (data == NULL || !readHLL(jp->sketch, data)) {
+		destroyHLL(jp->sketch);
+		jp->words = -1;
+	    }
+	}
+
+	free(data);
+
+	if (jp->words >= 0)
+	    return;
+    }
+
+    if ((fp = fopen(jp->path, "r")) == NULL)
+	return;
+
+    jp->words = 0;
+    rp = createReader(fp);
+
+    if (aflag) {
+	jp->sketch = createHLL();
+
+	while ((buffer = readWord(rp, NULL)) != NULL) {
+	    jp->words ++;
+	    addHLL(jp->sketch, buffer);
+	}
+
+	jp->distinct = estimateHLL(jp->sketch) + 0.5;
+
+    } else {
+	unique = createSet(MAX_SIZE);
+	jp->words = loadFile(unique, rp);
+	jp->distinct = numElements(unique);
+	destroySet(unique);
+    }
+
+    destroyReader(rp);
+    fclose(fp);
+
+    if (cache != NULL) {
+	if (aflag)
+	    writeHLL(jp->sketch, text);
+
+	addEntry(cache, kind, jp->path, &st, jp->words, jp->distinct, aflag ? text : NULL);
+    }
+}
+
+
+/*
+ * Function:    worker
+ *
+ * Description: Thread function for batch mode.  Count files from the batch
+ *		pointed to by ARG until there are none left.
+ */
+
+static void *worker(void *arg)
+{
+    struct batch *bp = arg;
+    struct job *jp;
+
+
+    while (1) {
+	pthread_mutex_lock(&bp->lock);
+	jp = bp->next < bp->njobs ? &bp->jobs[bp->next ++] : NULL;
+	pthread_mutex_unlock(&bp->lock);
+
+	if (jp == NULL)
+	    return NULL;
+
+	countFile(jp, bp->aflag, bp->cache);
+    }
+}
+
+
+/*
+ * Function:    runBatch
+ *
+ * Description: Count every file in the batch pointed to by BP using a pool
+ *		of NTHREADS threads, one of which is the calling thread.
+ */
+
+static void runBatch(struct batch *bp, int nthreads)
+{
+    pthread_t threads[MAX_THREADS];
+    int i, started;
+
+
+    if (nthreads > bp->njobs)
+	nthreads = bp->njobs;
+
+    bp->next = 0;
+    pthread_mutex_init(&bp->lock, NULL);
+
+    for (started = 0; started < nthreads - 1; started ++)
+	if (pthread_create(&threads[started], NULL, worker, bp) != 0)
+	    break;
+
+    worker(bp);
+
+    for (i = 0; i < started; i ++)
+	pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&bp->lock);
+}
+
+
+/*
+ * Function:    readList
+ *
+ * Description: Read the file names, separated by whitespace, from the file
+ *		named PATH into a new array at *NAMES.  Return the number of
+ *		names, or -1 if the file cannot be opened.
+ */
+
+static int readList(char *path, char ***names)
+{
+    FILE *fp;
+    READER *rp;
+    char *name;
+    int n, length;
+
+
+    if ((fp = fopen(path, "r")) == NULL)
+	return -1;
+
+    n = 0;
+    length = 16;
+    *names = malloc(sizeof(char *) * length);
+    assert(*names != NULL);
+
+    rp = createReader(fp);
+
+    while ((name = readWord(rp, NULL)) != NULL) {
+	if (n == length) {
+	    length *= 2;
+	    *names = realloc(*names, sizeof(char *) * length);
+	    assert(*names != NULL);
+	}
+
+	(*names)[n] = strdup(name);
+	assert((*names)[n] != NULL);
+	n ++;
+    }
+
+    destroyReader(rp);
+    fclose(fp);
+    return n;
+}
 
 
 /*
@@ -35,43 +322,185 @@
 int main(int argc, char *argv[])
 {
     FILE *fp;
-    char buffer[BUFSIZ], **elts;
+    READER *rp;
+    char *buffer, **elts;
     SET *unique;
-    int i, words;
-    bool lflag = false;
+    HLL *sketch;
+    struct batch batch;
+    struct job job;
+    CACHE *cache = NULL;
+    char *list = NULL;
+    int i, n, words, nthreads = 1;
+    bool lflag = false, aflag = false, bflag = false, usage;
 
 
     /* Check usage and open the first file. */
 
-    if (argc > 1 && strcmp(argv[1], "-l") == 0) {
-	lflag = true;
-	argc --;
+    while (argc > 1 && argv[1][0] == '-') {
+	n = 1;
+
+	if (strcmp(argv[1], "-l") == 0)
+	    lflag = true;
+	else if (strcmp(argv[1], "-a") == 0)
+	    aflag = true;
+	else if (strcmp(argv[1], "-b") == 0)
+	    bflag = true;
+	else if (strcmp(argv[1], "-f") == 0 && argc > 2) {
+	    list = argv[2];
+	    n = 2;
+	} else if (strcmp(argv[1], "-j") == 0 && argc > 2) {
+	    nthreads = atoi(argv[2]);
+	    n = 2;
+	} else if (strcmp(argv[1], "-c") == 0 && argc > 2) {
+	    cache = createCache(argv[2]);
+	    n = 2;
+	} else
+	    break;
+
+	argc -= n;
 
 	for (i = 1; i < argc; i ++)
-	    argv[i] = argv[i + 1];
+	    argv[i] = argv[i + n];
     }
 
-    if (argc == 1 || argc > 3) {
-        fprintf(stderr, "usage: %s [-l] file1 [file2]\n", argv[0]);
+    if (bflag || list != NULL)
+	usage = lflag || nthreads < 1 || nthreads > MAX_THREADS ||
+	    (list != NULL) == (argc > 1);
+    else
+	usage = argc == 1 || argc > 3 || (aflag && (lflag || argc > 2));
+
+    if (usage) {
+        fprintf(stderr, "usage: %s [-c cache] [-l] file1 [file2]\n", argv[0]);
+        fprintf(stderr, "       %s [-c cache] -a file1\n", argv[0]);
+        fprintf(stderr, "       %s [-c cache] [-a] [-j N] -b file...\n", argv[0]);
+        fprintf(stderr, "       %s [-c cache] [-a] [-j N] -f list\n", argv[0]);
         exit(EXIT_FAILURE);
     }
 
+
+    /* Count each file on its own in batch mode. */
+
+    if (bflag || list != NULL) {
+	if (list == NULL) {
+	    batch.njobs = argc - 1;
+	    elts = argv + 1;
+	} else if ((batch.njobs = readList(list, &elts)) < 0) {
+	    fprintf(stderr, "%s: cannot open %s\n", argv[0], list);
+	    exit(EXIT_FAILURE);
+	}
+
+	batch.jobs = malloc(sizeof(struct job) * (batch.njobs + 1));
+	assert(batch.jobs != NULL);
+	batch.aflag = aflag;
+	batch.cache = cache;
+
+	for (i = 0; i < batch.njobs; i ++)
+	    batch.jobs[i].path = elts[i];
+
+	runBatch(&batch, nthreads);
+
+	words = 0;
+	sketch = aflag ? createHLL() : NULL;
+
+	for (i = 0; i < batch.njobs; i ++) {
+	    if (batch.jobs[i].words < 0) {
+		fprintf(stderr, "%s: cannot open %s\n", argv[0], elts[i]);
+		continue;
+	    }
+
+	    words += batch.jobs[i].words;
+
+	    if (aflag) {
+		printf("%s: %d total words, %.0f distinct words (estimated)\n",
+		    elts[i], batch.jobs[i].words,
+		    estimateHLL(batch.jobs[i].sketch));
+		mergeHLL(sketch, batch.jobs[i].sketch);
+		destroyHLL(batch.jobs[i].sketch);
+	    } else
+		printf("%s: %d total words, %d distinct words\n", elts[i],
+		    batch.jobs[i].words, batch.jobs[i].distinct);
+	}
+
+	printf("%d total words\n", words);
+
+	if (aflag) {
+	    printf("%.0f distinct words (estimated)\n", estimateHLL(sketch));
+	    destroyHLL(sketch);
+	}
+
+	if (cache != NULL)
+	    destroyCache(cache);
+
+	if (list != NULL) {
+	    for (i = 0; i < batch.njobs; i ++)
+		free(elts[i]);
+
+	    free(elts);
+	}
+
+	free(batch.jobs);
+	exit(EXIT_SUCCESS);
+    }
+
+
+    /* Only the counts are wanted, so they may come from the cache. */
+
+    if (cache != NULL && !lflag && argc == 2) {
+	job.path = argv[1];
+	countFile(&job, aflag, cache);
+	destroyCache(cache);
+
+	if (job.words < 0) {
+	    fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+	    exit(EXIT_FAILURE);
+	}
+
+	printf("%d total words\n", job.words);
+
+	if (aflag) {
+	    printf("%.0f distinct words (estimated)\n", estimateHLL(job.sketch));
+	    destroyHLL(job.sketch);
+	} else
+	    printf("%d distinct words\n", job.distinct);
+
+	exit(EXIT_SUCCESS);
+    }
+
     if ((fp = fopen(argv[1], "r")) == NULL) {
         fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
         exit(EXIT_FAILURE);
     }
 
 
-    /* Insert all words into the set. */
+    /* Estimate the distinct words without a set if desired. */
 
-    words = 0;
-    unique = createSet(MAX_SIZE);
+    if (aflag) {
+	words = 0;
+	sketch = createHLL();
+	rp = createReader(fp);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
-        words ++;
-        addElement(unique, buffer);
+	while ((buffer = readWord(rp, NULL)) != NULL) {
+	    words ++;
+	    addHLL(sketch, buffer);
+	}
+
+	destroyReader(rp);
+	fclose(fp);
+
+	printf("%d total words\n", words);
+	printf("%.0f distinct words (estimated)\n", estimateHLL(sketch));
+
+	destroyHLL(sketch);
+	exit(EXIT_SUCCESS);
     }
 
+
+    /* Insert all words into the set. */
+
+    unique = createSet(MAX_SIZE);
+    rp = createReader(fp);
+    words = loadFile(unique, rp);
+    destroyReader(rp);
     fclose(fp);
 
     if (!lflag) {
@@ -91,9 +520,12 @@ int main(int argc, char *argv[])
 
         /* Delete all words in the second file. */
 
-        while (fscanf(fp, "%s", buffer) == 1)
+        rp = createReader(fp);
+
+        while ((buffer = readWord(rp, NULL)) != NULL)
             removeElement(unique, buffer);
 
+	destroyReader(rp);
 	fclose(fp);
 
 	if (!lflag)
@@ -0,0 +1,26 @@
+/*
+ * File:        cache.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for a cache of per-file results kept on disk.
+ *              A result is found again only while the file still has the
+ *              same path, size, and modification time.
+ */
+
+# ifndef CACHE_H
+# define CACHE_H
+
+# include <stdbool.h>
+# include <sys/stat.h>
+
+typedef struct cache CACHE;
+
+CACHE *createCache(char *path);
+
+void destroyCache(CACHE *cp);
+
+bool findEntry(CACHE *cp, char *kind, char *file, struct stat *st, long *words, long *distinct, char **data);
+
+void addEntry(CACHE *cp, char *kind, char *file, struct stat *st, long words, long distinct, char *data);
+
+# endif /* CACHE_H */
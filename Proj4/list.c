@@ -272,8 +272,9 @@ void *getItems (LIST *lp) {
 	assert(items != NULL);
 	int i = 0;
 	NODE *np = lp -> head -> next;
-	while(np -> next != lp -> head) {
+	while(np != lp -> head) {
 		items[i] = np -> data;
+		np = np -> next;
 		i++;
 	}
 	return items;
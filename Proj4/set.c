@@ -163,7 +163,8 @@ void *getElements(SET *sp)
     
 	assert(sp != NULL);
 	void **dataCopy;
-	dataCopy = malloc(sizeof(void *)*sp->length*EXP);
+	dataCopy = malloc(sizeof(void *)*sp->count);
+	assert(dataCopy != NULL || sp->count == 0);
     void **dataInsert;
     int numInsert;
     int size;
@@ -174,6 +175,7 @@ void *getElements(SET *sp)
         numInsert = numItems(sp->list[i]);
         size = sizeof(getFirst(sp->list[i]));
         memcpy(dataCopy+index,dataInsert,numInsert*size);
+        free(dataInsert);
         index += numInsert;
 	}
     
@@ -13,7 +13,9 @@
  *              This implementation uses a hash table to store the
  *              elements, with linear probing to resolve collisions.
  *              Insertion, deletion, and membership checks are all average
- *              case constant time.
+ *              case constant time.  The table doubles when it is 3/4
+ *              full, and later changes move the elements into the new
+ *              table a few at a time.
  *
  *				Modifications is to return a sorted array in getElements
  *				instead of an unsorted array.
@@ -29,58 +31,231 @@
 # define EMPTY   0
 # define FILLED  1
 # define DELETED 2
+# define MIGRATE 16		/* slots moved by each change      */
 
 struct set {
     int count;                  /* number of elements in array */
-    int length;                 /* length of allocated array   */
+    int length;                 /* length, a power of two      */
     void **data;                /* array of allocated elements */
     char *flags;                /* state of each slot in array */
     int (*compare)();		/* comparison function         */
     unsigned (*hash)();		/* hash function               */
+    void **oldData;		/* elements still being moved  */
+    char *oldFlags;		/* state of each old slot      */
+    int oldLength;		/* length of old array, or 0   */
+    int moved;			/* old slots already moved     */
 };
 
 void quicksort(int (*compare)(), void *a[], int lo, int hi);
 int partition(int (*compare)(), void *a[], int lo, int hi);
 
 /*
- * Function:    search
+ * Function:    home
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the home slot of ELT in a table of LENGTH slots in
+ *		the set pointed to by SP.  The hash is put through the
+ *		32-bit finalizer of MurmurHash3, so that the low bits kept
+ *		by the mask depend on all of its bits, even for a hash
+ *		function whose low bits are poor.
+ */
+
+static int home(SET *sp, void *elt, int length)
+{
+    unsigned hash;
+
+
+    hash = (*sp->hash)(elt);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+
+    return hash & (length - 1);
+}
+
+
+/*
+ * Function:    probe
  *
  * Complexity:  O(1) average case, O(n) worst case
  *
- * Description: Return the location of ELT in the set pointed to by SP.  If
+ * Description: Return the location of ELT in the table DATA of LENGTH
+ *		slots with states FLAGS in the set pointed to by SP.  If
  *		the element is present, then *FOUND is true.  If not
- *		present, then *FOUND is false.  The element is first hashed
- *		to its correct location.  Linear probing is used to examine
- *		subsequent locations.
+ *		present, then *FOUND is false and the empty slot that ended
+ *		the search is returned.  The element is first hashed to its
+ *		correct location.  Linear probing is used to examine
+ *		subsequent locations, passing over deleted slots, which are
+ *		only found in an old table.
  */
 
-static int search(SET *sp, void *elt, bool *found)
+static int probe(SET *sp, void **data, char *flags, int length, void *elt,
+    bool *found)
 {
-    int available, i, locn, start;
+    int i, locn, start, mask;
 
 
-    available = -1;
-    start = (*sp->hash)(elt) % sp->length;
+    mask = length - 1;
+    start = home(sp, elt, length);
 
-    for (i = 0; i < sp->length; i ++) {
-        locn = (start + i) % sp->length;
+    for (i = 0; i < length; i ++) {
+        locn = (start + i) & mask;
 
-        if (sp->flags[locn] == EMPTY) {
+        if (flags[locn] == EMPTY) {
             *found = false;
-            return available != -1 ? available : locn;
-
-        } else if (sp->flags[locn] == DELETED) {
-            if (available == -1)
-		available = locn;
+            return locn;
 
-        } else if ((*sp->compare)(sp->data[locn], elt) == 0) {
+        } else if (flags[locn] == FILLED &&
+	    (*sp->compare)(data[locn], elt) == 0) {
             *found = true;
             return locn;
         }
     }
 
     *found = false;
-    return available;
+    return -1;
+}
+
+
+/*
+ * Function:    search
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Return the location of ELT in the set pointed to by SP.  If
+ *		the element is present, then *FOUND is true.  If not
+ *		present, then *FOUND is false and the location in the new
+ *		table where it would be inserted is returned.  While the set
+ *		is growing, an element not in the new table may still be in
+ *		the old one, whose slots are counted after the new ones.
+ */
+
+static int search(SET *sp, void *elt, bool *found)
+{
+    int locn, old;
+
+
+    locn = probe(sp, sp->data, sp->flags, sp->length, elt, found);
+
+    if (*found || sp->oldLength == 0)
+	return locn;
+
+    old = probe(sp, sp->oldData, sp->oldFlags, sp->oldLength, elt, found);
+    return *found ? sp->length + old : locn;
+}
+
+
+/*
+ * Function:    shift
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Empty the slot HOLE in the new table of the set pointed to
+ *		by SP.  Each later element in the same run whose home slot
+ *		does not lie between HOLE and itself is moved back into the
+ *		hole, which then moves to where it was.  No slot of the new
+ *		table is ever marked deleted, so a search never has to probe
+ *		past stale slots.
+ */
+
+static void shift(SET *sp, int hole)
+{
+    int i, locn, start, mask;
+
+
+    mask = sp->length - 1;
+    locn = hole;
+
+    for (i = 1; i < sp->length; i ++) {
+	locn = (locn + 1) & mask;
+
+	if (sp->flags[locn] == EMPTY)
+	    break;
+
+	start = home(sp, sp->data[locn], sp->length);
+
+	if (((locn - start) & mask) >= ((locn - hole) & mask)) {
+	    sp->data[hole] = sp->data[locn];
+	    hole = locn;
+	}
+    }
+
+    sp->flags[hole] = EMPTY;
+}
+
+
+/*
+ * Function:    migrate
+ *
+ * Complexity:  O(1) average case
+ *
+ * Description: Move the next MIGRATE slots of the old table of the set
+ *		pointed to by SP into the new table, marking them deleted,
+ *		and free the old table once every slot has been moved.  The
+ *		new table can take 3/4 of its length before it must grow,
+ *		and the old table is half its length, so the old table is
+ *		always empty well before then.
+ */
+
+static void migrate(SET *sp)
+{
+    int i, locn, mask;
+
+
+    mask = sp->length - 1;
+
+    for (i = 0; i < MIGRATE && sp->oldLength > 0; i ++) {
+	if (sp->oldFlags[sp->moved] == FILLED) {
+	    locn = home(sp, sp->oldData[sp->moved], sp->length);
+
+	    while (sp->flags[locn] != EMPTY)
+		locn = (locn + 1) & mask;
+
+	    sp->data[locn] = sp->oldData[sp->moved];
+	    sp->flags[locn] = FILLED;
+	    sp->oldFlags[sp->moved] = DELETED;
+	}
+
+	if (++ sp->moved == sp->oldLength) {
+	    free(sp->oldData);
+	    free(sp->oldFlags);
+	    sp->oldLength = 0;
+	}
+    }
+}
+
+
+/*
+ * Function:    grow
+ *
+ * Complexity:  O(1) amortized
+ *
+ * Description: Make the table of the set pointed to by SP the old one and
+ *		start an empty table twice as long.  No element is moved
+ *		yet; later changes move them a few at a time.  The states
+ *		come from calloc, which gets a large table as fresh pages
+ *		that are already zero, so nothing is cleared all at once.
+ *		The last old table must already be empty (see migrate).
+ */
+
+static void grow(SET *sp)
+{
+    assert(sp->oldLength == 0);
+
+    sp->oldData = sp->data;
+    sp->oldFlags = sp->flags;
+    sp->oldLength = sp->length;
+    sp->moved = 0;
+    sp->length *= 2;
+
+    sp->data = malloc(sizeof(void *) * sp->length);
+    assert(sp->data != NULL);
+
+    sp->flags = calloc(sp->length, sizeof(char));
+    assert(sp->flags != NULL);
 }
 
 
@@ -89,13 +264,14 @@ static int search(SET *sp, void *elt, bool *found)
  *
  * Complexity:  O(m)
  *
- * Description: Return a pointer to a new set with a maximum capacity of
- *		MAXELTS.
+ * Description: Return a pointer to a new set with room for MAXELTS
+ *		elements before it grows.  The table is kept at most 3/4
+ *		full and its length is a power of two so that probing can
+ *		wrap around with a mask instead of a division.
  */
 
 SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
 {
-    int i;
     SET *sp;
 
 
@@ -104,19 +280,21 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
     sp = malloc(sizeof(SET));
     assert(sp != NULL);
 
-    sp->data = malloc(sizeof(char *) * maxElts);
+    sp->length = 1;
+
+    while (sp->length / 4 * 3 < maxElts)
+	sp->length *= 2;
+
+    sp->data = malloc(sizeof(char *) * sp->length);
     assert(sp->data != NULL);
 
-    sp->flags = malloc(sizeof(char) * maxElts);
+    sp->flags = calloc(sp->length, sizeof(char));
     assert(sp->flags != NULL);
 
     sp->compare = compare;
     sp->hash = hash;
-    sp->length = maxElts;
     sp->count = 0;
-
-    for (i = 0; i < maxElts; i ++)
-        sp->flags[i] = EMPTY;
+    sp->oldLength = 0;
 
     return sp;
 }
@@ -137,6 +315,11 @@ void destroySet(SET *sp)
 {
     assert(sp != NULL);
 
+    if (sp->oldLength > 0) {
+	free(sp->oldFlags);
+	free(sp->oldData);
+    }
+
     free(sp->flags);
     free(sp->data);
     free(sp);
@@ -163,7 +346,11 @@ int numElements(SET *sp)
  *
  * Complexity:  O(1) average case, O(n) worst case
  *
- * Description: Add ELT to the set pointed to by SP.
+ * Description: Add ELT to the set pointed to by SP.  The table doubles
+ *		once it is 3/4 full, and while it is growing each change
+ *		moves a few slots of the old table into the new one, so no
+ *		single change pays to move every element.  New elements
+ *		always go into the new table.
  */
 
 void addElement(SET *sp, void *elt)
@@ -173,11 +360,14 @@ void addElement(SET *sp, void *elt)
 
 
     assert(sp != NULL && elt != NULL);
+
+    if (sp->count >= sp->length / 4 * 3)
+	grow(sp);
+
+    migrate(sp);
     locn = search(sp, elt, &found);
 
     if (!found) {
-	assert(sp->count < sp->length);
-
 	sp->data[locn] = elt;
 	sp->flags[locn] = FILLED;
 	sp->count ++;
@@ -190,8 +380,10 @@ void addElement(SET *sp, void *elt)
  *
  * Complexity:  O(1) average case, O(n) worst case
  *
- * Description: Remove ELT from the set pointed to by SP.  A element is
- *		deleted by changing the state of its slot.
+ * Description: Remove ELT from the set pointed to by SP.  The elements
+ *		after it in its run are shifted back to fill its slot.  An
+ *		element still in the old table is just marked deleted, since
+ *		nothing is ever added to the old table.
  */
 
 void removeElement(SET *sp, void *elt)
@@ -201,10 +393,16 @@ void removeElement(SET *sp, void *elt)
 
 
     assert(sp != NULL && elt != NULL);
+
+    migrate(sp);
     locn = search(sp, elt, &found);
 
     if (found) {
-	sp->flags[locn] = DELETED;
+	if (locn < sp->length)
+	    shift(sp, locn);
+	else
+	    sp->oldFlags[locn - sp->length] = DELETED;
+
 	sp->count --;
     }
 }
@@ -216,7 +414,8 @@ void removeElement(SET *sp, void *elt)
  * Complexity:  O(1) average case, O(n) worst case
  *
  * Description: If ELT is present in the set pointed to by SP then return
- *		it, otherwise return NULL.
+ *		it, otherwise return NULL.  No slots are moved, so a find
+ *		never pays for growing.
  */
 
 void *findElement(SET *sp, void *elt)
@@ -228,7 +427,11 @@ void *findElement(SET *sp, void *elt)
     assert(sp != NULL && elt != NULL);
 
     locn = search(sp, elt, &found);
-    return found ? sp->data[locn] : NULL;
+
+    if (!found)
+	return NULL;
+
+    return locn < sp->length ? sp->data[locn] : sp->oldData[locn - sp->length];
 }
 
 
@@ -256,7 +459,11 @@ void *getElements(SET *sp)
 	if (sp->flags[i] == FILLED)
 	    elts[j ++] = sp->data[i];
 
-	quicksort(sp->compare, elts, 0, j-1);
+    for (i = 0; i < sp->oldLength; i ++)
+	if (sp->oldFlags[i] == FILLED)
+	    elts[j ++] = sp->oldData[i];
+
+    quicksort(sp->compare, elts, 0, j-1);
 
     return elts;
 }